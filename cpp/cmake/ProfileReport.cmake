@@ -0,0 +1,211 @@
+#############################################################################
+# micrometrics build profile report
+#
+# Builds the benchmark suite under each build profile in its own build tree
+# and times every suite entry, then prints a table of wall-clock seconds and
+# the speedup over the Debug build. Invoked by the `profile-report` target:
+#
+#   cmake -DSOURCE_DIR=<cpp> -DWORK_DIR=<dir> -DGENERATOR=<gen>
+#         -DCXX_COMPILER=<c++> -DSUITE=<target|args;...>
+#         -P ProfileReport.cmake
+#
+# Profiles
+#   debug       CMAKE_BUILD_TYPE=Debug
+#   release     CMAKE_BUILD_TYPE=Release
+#   native      Release + -O3 -march=native
+#   lto         Release + link-time optimization
+#   native-lto  native + lto
+#   pgo         native + lto + profile-guided optimization (generate, train
+#               on the suite, rebuild with the profile, all in one build dir)
+#
+# The report is also written to <WORK_DIR>/profile-report.md.
+#
+# Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# See (https://github.com/augustodamasceno/micrometrics)
+#############################################################################
+cmake_minimum_required(VERSION 3.16)
+
+foreach(REQUIRED_VAR SOURCE_DIR WORK_DIR SUITE)
+    if(NOT DEFINED ${REQUIRED_VAR})
+        message(FATAL_ERROR "ProfileReport.cmake: ${REQUIRED_VAR} is not set.")
+    endif()
+endforeach()
+
+if(CMAKE_VERSION VERSION_LESS 3.23)
+    message(WARNING "CMake < 3.23 has no sub-second timestamps: timings are whole seconds.")
+endif()
+
+set(PROFILES debug release native lto native-lto pgo)
+set(PROFILE_ARGS_debug      -DCMAKE_BUILD_TYPE=Debug)
+set(PROFILE_ARGS_release    -DCMAKE_BUILD_TYPE=Release)
+set(PROFILE_ARGS_native     -DCMAKE_BUILD_TYPE=Release -DMICROMETRICS_NATIVE=ON)
+set(PROFILE_ARGS_lto        -DCMAKE_BUILD_TYPE=Release -DMICROMETRICS_LTO=ON)
+set(PROFILE_ARGS_native-lto -DCMAKE_BUILD_TYPE=Release -DMICROMETRICS_NATIVE=ON
+                            -DMICROMETRICS_LTO=ON)
+set(PROFILE_ARGS_pgo        -DCMAKE_BUILD_TYPE=Release -DMICROMETRICS_NATIVE=ON
+                            -DMICROMETRICS_LTO=ON)
+
+set(CONFIGURE_EXTRA)
+if(GENERATOR)
+    list(APPEND CONFIGURE_EXTRA -G "${GENERATOR}")
+endif()
+if(CXX_COMPILER)
+    list(APPEND CONFIGURE_EXTRA -DCMAKE_CXX_COMPILER=${CXX_COMPILER})
+endif()
+
+# Microseconds since the epoch (%f is the 6-digit fraction, CMake >= 3.23).
+function(now_us OUT)
+    if(CMAKE_VERSION VERSION_LESS 3.23)
+        string(TIMESTAMP T "%s000000")
+    else()
+        string(TIMESTAMP T "%s%f")
+    endif()
+    set(${OUT} "${T}" PARENT_SCOPE)
+endfunction()
+
+function(run_checked)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE RC OUTPUT_QUIET)
+    if(NOT RC EQUAL 0)
+        message(FATAL_ERROR "Command failed (${RC}): ${ARGN}")
+    endif()
+endfunction()
+
+function(configure_and_build BUILD_DIR)
+    run_checked(${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${BUILD_DIR} ${CONFIGURE_EXTRA} ${ARGN})
+    run_checked(${CMAKE_COMMAND} --build ${BUILD_DIR} --parallel)
+endfunction()
+
+# Runs every suite entry once; sets <OUT> to the per-entry milliseconds.
+function(time_suite BUILD_DIR OUT)
+    set(TIMES)
+    foreach(ENTRY ${SUITE})
+        string(REPLACE "|" ";" PARTS "${ENTRY}")
+        list(GET PARTS 0 TARGET)
+        list(GET PARTS 1 ARGS)
+        separate_arguments(ARGS)
+        now_us(T0)
+        execute_process(COMMAND ${BUILD_DIR}/${TARGET} ${ARGS}
+                        RESULT_VARIABLE RC OUTPUT_QUIET ERROR_QUIET)
+        now_us(T1)
+        if(NOT RC EQUAL 0)
+            message(FATAL_ERROR "${TARGET} ${ARGS} failed (${RC}).")
+        endif()
+        math(EXPR MS "(${T1} - ${T0}) / 1000")
+        list(APPEND TIMES ${MS})
+    endforeach()
+    set(${OUT} ${TIMES} PARENT_SCOPE)
+endfunction()
+
+# "<ms>" as seconds with three decimals.
+function(format_seconds MS OUT)
+    math(EXPR S "${MS} / 1000")
+    math(EXPR F "${MS} % 1000")
+    string(LENGTH "${F}" L)
+    while(L LESS 3)
+        string(PREPEND F "0")
+        string(LENGTH "${F}" L)
+    endwhile()
+    set(${OUT} "${S}.${F}" PARENT_SCOPE)
+endfunction()
+
+# Speedup BASE / MS with two decimals.
+function(format_speedup BASE MS OUT)
+    if(MS LESS_EQUAL 0)
+        set(${OUT} "n/a" PARENT_SCOPE)
+        return()
+    endif()
+    math(EXPR X "(${BASE} * 100 + ${MS} / 2) / ${MS}")
+    math(EXPR I "${X} / 100")
+    math(EXPR F "${X} % 100")
+    if(F LESS 10)
+        set(F "0${F}")
+    endif()
+    set(${OUT} "${I}.${F}x" PARENT_SCOPE)
+endfunction()
+
+
+#############################################################################
+# Build and time every profile
+#############################################################################
+file(MAKE_DIRECTORY ${WORK_DIR})
+foreach(PROFILE ${PROFILES})
+    set(BUILD_DIR ${WORK_DIR}/${PROFILE})
+    message(STATUS "[${PROFILE}] building in ${BUILD_DIR}")
+    if(PROFILE STREQUAL "pgo")
+        set(PGO_DIR ${BUILD_DIR}/pgo-data)
+        file(REMOVE_RECURSE ${PGO_DIR})
+        configure_and_build(${BUILD_DIR} ${PROFILE_ARGS_pgo}
+                            -DMICROMETRICS_PGO=GENERATE -DMICROMETRICS_PGO_DIR=${PGO_DIR})
+        message(STATUS "[${PROFILE}] training")
+        run_checked(${CMAKE_COMMAND} --build ${BUILD_DIR} --target pgo-train)
+        configure_and_build(${BUILD_DIR} ${PROFILE_ARGS_pgo}
+                            -DMICROMETRICS_PGO=USE -DMICROMETRICS_PGO_DIR=${PGO_DIR})
+    else()
+        configure_and_build(${BUILD_DIR} ${PROFILE_ARGS_${PROFILE}})
+    endif()
+    message(STATUS "[${PROFILE}] timing the suite")
+    time_suite(${BUILD_DIR} TIMES_${PROFILE})
+endforeach()
+
+
+#############################################################################
+# Report
+#############################################################################
+set(HEADER "| Benchmark | Arguments |")
+set(RULE "|---|---|")
+foreach(PROFILE ${PROFILES})
+    string(APPEND HEADER " ${PROFILE} |")
+    string(APPEND RULE "---:|")
+endforeach()
+set(REPORT "${HEADER}\n${RULE}\n")
+
+list(LENGTH SUITE N)
+math(EXPR LAST "${N} - 1")
+foreach(INDEX RANGE ${LAST})
+    list(GET SUITE ${INDEX} ENTRY)
+    string(REPLACE "|" ";" PARTS "${ENTRY}")
+    list(GET PARTS 0 TARGET)
+    list(GET PARTS 1 ARGS)
+    string(REGEX REPLACE "^src_" "" TARGET "${TARGET}")
+    list(GET TIMES_debug ${INDEX} BASE)
+    set(ROW "| ${TARGET} | ${ARGS} |")
+    foreach(PROFILE ${PROFILES})
+        list(GET TIMES_${PROFILE} ${INDEX} MS)
+        format_seconds(${MS} SECONDS)
+        if(PROFILE STREQUAL "debug")
+            string(APPEND ROW " ${SECONDS} s |")
+        else()
+            format_speedup(${BASE} ${MS} SPEEDUP)
+            string(APPEND ROW " ${SECONDS} s (${SPEEDUP}) |")
+        endif()
+    endforeach()
+    string(APPEND REPORT "${ROW}\n")
+endforeach()
+
+set(ROW "| **total** | |")
+set(BASE_TOTAL 0)
+foreach(MS ${TIMES_debug})
+    math(EXPR BASE_TOTAL "${BASE_TOTAL} + ${MS}")
+endforeach()
+foreach(PROFILE ${PROFILES})
+    set(TOTAL 0)
+    foreach(MS ${TIMES_${PROFILE}})
+        math(EXPR TOTAL "${TOTAL} + ${MS}")
+    endforeach()
+    format_seconds(${TOTAL} SECONDS)
+    if(PROFILE STREQUAL "debug")
+        string(APPEND ROW " ${SECONDS} s |")
+    else()
+        format_speedup(${BASE_TOTAL} ${TOTAL} SPEEDUP)
+        string(APPEND ROW " ${SECONDS} s (${SPEEDUP}) |")
+    endif()
+endforeach()
+string(APPEND REPORT "${ROW}\n")
+
+file(WRITE ${WORK_DIR}/profile-report.md
+     "## Build profiles\n\nWall-clock seconds per suite entry (speedup vs debug).\n\n${REPORT}")
+message("\n${REPORT}")
+message(STATUS "Report written to ${WORK_DIR}/profile-report.md")
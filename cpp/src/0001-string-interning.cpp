@@ -1,6 +1,6 @@
 /* micrometrics : Symbol Interning Profiling
  *
- * Two benchmark scenarios:
+ * Benchmark scenarios:
  *
  *  [1-to-1]   Each incoming symbol is matched against one target once.
  *             Registry: get_id(sym) + (id == target_id)   — 1 lookup, 1 cmp
@@ -16,6 +16,32 @@
  *             Fanout swept from 8 to 1024 (doubling each step).
  *             A summary table is printed at the end.
  *
+ *  [fanout-specialization] The 1-to-many sweep again, with the fanout as
+ *             a template parameter (template <std::size_t Fanout>) so the
+ *             inner loop bound is a compile-time constant the compiler can
+ *             unroll and vectorize. Runtime-bound vs compile-time-bound is
+ *             reported for both the registry and the direct path.
+ *
+ *  [fixed-symbol] Every scenario is also run over the same stream stored
+ *             as FixedSymbol<16> (15 inline bytes + length, 16 bytes,
+ *             trivially copyable, word-wise ==, hash and <) instead of
+ *             std::string (32 bytes + SSO branch). Bytes per message are
+ *             printed at start-up. The 1-to-1 test also looks the stream
+ *             up in an unordered_map keyed by std::string vs one keyed by
+ *             FixedSymbol<16>, which times the word-wise hash.
+ *
+ *  [memory-resource] SymbolRegistry built on each std::pmr resource:
+ *             new_delete, unsynchronized_pool, synchronized_pool and
+ *             monotonic_buffer. Build = intern SYMBOL_POOL plus a synthetic
+ *             universe of UNIVERSE long (heap-allocated) symbols; Lookup =
+ *             get_id over the incoming stream on the built registry.
+ *
+ *  [metrics]  get_id over the stream on SymbolRegistry vs
+ *             InstrumentedSymbolRegistry (per-thread padded counters for
+ *             lookups, misses, inserts and lock-wait cycles), 1 and 4
+ *             threads sharing one registry, over both streams. Reported:
+ *             overhead of the counters and one aggregated snapshot.
+ *
  * Design notes
  *   - Incoming stream is a vector of std::string copies, not references
  *     into SYMBOL_POOL, eliminating the pointer-identity shortcut that
@@ -38,42 +64,234 @@
  * See (https://github.com/augustodamasceno/micrometrics)
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <random>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define MM_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MM_HAS_TSC 1
+#endif
+
+
+// Time stamp for lock-wait accounting: TSC cycles on x86, ns elsewhere.
+static inline uint64_t wait_clock() {
+#if defined(MM_HAS_TSC)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
 
-class SymbolRegistry {
+// Aggregated registry counters; every miss inserts, so misses == inserts
+// unless an insert threw.
+struct RegistryMetrics {
+    uint64_t lookups          = 0;
+    uint64_t misses           = 0;
+    uint64_t inserts          = 0;
+    uint64_t lock_waits       = 0;   // get_id calls that found mtx taken
+    uint64_t lock_wait_cycles = 0;   // wait_clock() units spent blocked on mtx
+};
+
+/* The map nodes, the id vector and every interned string are allocated
+ * from one std::pmr::memory_resource (the default resource unless given);
+ * only the transient probe key of a lookup comes from the default resource.
+ *
+ * Instrumented = true adds RegistryMetrics counters. Each thread owns one
+ * cache-line-sized slot (past METRIC_SLOTS threads, slots are shared) and
+ * bumps it with a plain load + store while holding mtx, so counts stay
+ * exact even in a shared slot. The counters are relaxed atomics only so
+ * that metrics() can sum the slots while get_id runs. The uncontended lock
+ * path costs one try_lock; only a thread that has to wait reads the clock. */
+template <bool Instrumented>
+class BasicSymbolRegistry {
 private:
-    std::unordered_map<std::string, uint32_t> string_to_id_;
-    std::vector<std::string> id_to_string_;
+    static constexpr std::size_t METRIC_SLOTS = 64;
+
+    struct alignas(64) MetricSlot {
+        std::atomic<uint64_t> lookups{0}, misses{0}, inserts{0}, lock_waits{0}, lock_wait_cycles{0};
+    };
+
+    std::pmr::unordered_map<std::pmr::string, uint32_t> string_to_id_;
+    std::pmr::vector<std::pmr::string> id_to_string_;
     std::mutex mtx;
+    std::unique_ptr<MetricSlot[]> slots_;
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // Constant-initialized thread_local: one TLS load per call, no guard.
+    static std::size_t thread_slot() {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t slot = METRIC_SLOTS;
+        if (slot == METRIC_SLOTS)
+            slot = next.fetch_add(1, std::memory_order_relaxed) % METRIC_SLOTS;
+        return slot;
+    }
+
+    std::mutex& lock_counted(MetricSlot* slot) {
+        if constexpr (Instrumented) {
+            if (!mtx.try_lock()) {
+                const uint64_t start = wait_clock();
+                mtx.lock();
+                bump(slot->lock_waits);
+                bump(slot->lock_wait_cycles, wait_clock() - start);
+            }
+        } else {
+            (void)slot;
+            mtx.lock();
+        }
+        return mtx;
+    }
 
 public:
+    explicit BasicSymbolRegistry(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : string_to_id_(resource), id_to_string_(resource),
+          slots_(Instrumented ? new MetricSlot[METRIC_SLOTS] : nullptr) {}
+
     uint32_t get_id(std::string_view symbol) {
-        std::lock_guard<std::mutex> lock(mtx);
-        auto it = string_to_id_.find(std::string(symbol));
+        MetricSlot* slot = Instrumented ? &slots_[thread_slot()] : nullptr;
+        std::lock_guard<std::mutex> lock(lock_counted(slot), std::adopt_lock);
+        if constexpr (Instrumented) bump(slot->lookups);
+        // Probe key from the default resource: a lookup must not grow a
+        // monotonic registry resource. The insert below copies it into the
+        // registry's resource (uses-allocator construction of the node).
+        std::pmr::string key(symbol, std::pmr::get_default_resource());
+        auto it = string_to_id_.find(key);
         if (it != string_to_id_.end()) return it->second;
 
+        if constexpr (Instrumented) bump(slot->misses);
         uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
-        string_to_id_[std::string(symbol)] = new_id;
+        string_to_id_[key] = new_id;
         id_to_string_.emplace_back(symbol);
+        if constexpr (Instrumented) bump(slot->inserts);
         return new_id;
     }
 
     inline std::string_view get_symbol(uint32_t id) const {
         return id_to_string_.at(id);
     }
+
+    RegistryMetrics metrics() const {
+        static_assert(Instrumented, "metrics() needs BasicSymbolRegistry<true>");
+        RegistryMetrics m;
+        for (std::size_t i = 0; i < METRIC_SLOTS; ++i) {
+            const MetricSlot& s = slots_[i];
+            m.lookups          += s.lookups.load(std::memory_order_relaxed);
+            m.misses           += s.misses.load(std::memory_order_relaxed);
+            m.inserts          += s.inserts.load(std::memory_order_relaxed);
+            m.lock_waits       += s.lock_waits.load(std::memory_order_relaxed);
+            m.lock_wait_cycles += s.lock_wait_cycles.load(std::memory_order_relaxed);
+        }
+        return m;
+    }
+};
+
+using SymbolRegistry             = BasicSymbolRegistry<false>;
+using InstrumentedSymbolRegistry = BasicSymbolRegistry<true>;
+
+
+/* Fixed-capacity symbol: N-1 inline bytes, zero padded, and the length in
+ * the last byte. Trivially copyable, no heap, no SSO branch; equality,
+ * hashing and ordering work on whole 64-bit words. Ordering is
+ * lexicographic as long as symbols contain no NUL bytes. */
+template <std::size_t N>
+class FixedSymbol {
+    static_assert(N >= 8 && N % 8 == 0 && N <= 256, "N must be a multiple of 8, at most 256");
+
+private:
+    static constexpr std::size_t WORDS = N / 8;
+    alignas(8) char bytes_[N] = {};
+
+    uint64_t word(std::size_t i) const {
+        uint64_t w;
+        std::memcpy(&w, bytes_ + i * 8, 8);
+        return w;
+    }
+
+    // Big-endian load, so that integer order equals byte order.
+    uint64_t word_be(std::size_t i) const {
+        uint64_t w = 0;
+        for (std::size_t k = 0; k < 8; ++k)
+            w = (w << 8) | static_cast<unsigned char>(bytes_[i * 8 + k]);
+        return w;
+    }
+
+public:
+    static constexpr std::size_t capacity = N - 1;
+
+    FixedSymbol() = default;
+
+    explicit FixedSymbol(std::string_view symbol) {
+        if (symbol.size() > capacity) throw std::length_error("FixedSymbol: symbol too long");
+        std::memcpy(bytes_, symbol.data(), symbol.size());
+        bytes_[N - 1] = static_cast<char>(symbol.size());
+    }
+
+    std::size_t size() const { return static_cast<unsigned char>(bytes_[N - 1]); }
+    std::string_view view() const { return {bytes_, size()}; }
+    operator std::string_view() const { return view(); }
+
+    friend bool operator==(const FixedSymbol& a, const FixedSymbol& b) {
+        uint64_t diff = 0;
+        for (std::size_t i = 0; i < WORDS; ++i) diff |= a.word(i) ^ b.word(i);
+        return diff == 0;
+    }
+    friend bool operator!=(const FixedSymbol& a, const FixedSymbol& b) { return !(a == b); }
+
+    friend bool operator<(const FixedSymbol& a, const FixedSymbol& b) {
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            const uint64_t x = a.word_be(i), y = b.word_be(i);
+            if (x != y) return x < y;
+        }
+        return false;
+    }
+
+    std::size_t hash() const {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            h ^= word(i);
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+        return static_cast<std::size_t>(h);
+    }
 };
 
+namespace std {
+template <std::size_t N>
+struct hash<FixedSymbol<N>> {
+    std::size_t operator()(const FixedSymbol<N>& s) const noexcept { return s.hash(); }
+};
+}  // namespace std
+
+using Ticker = FixedSymbol<16>;
+static_assert(std::is_trivially_copyable<Ticker>::value, "Ticker must be trivially copyable");
+static_assert(sizeof(Ticker) == 16, "Ticker must be 16 bytes");
+
 
 static const std::vector<std::string> SYMBOL_POOL = {
     // Equities
@@ -117,6 +335,71 @@ generate_incoming_stream(std::size_t n, unsigned seed = 42) {
 }
 
 
+/* The same stream as FixedSymbol values. */
+template <std::size_t N>
+static std::vector<FixedSymbol<N>>
+to_fixed_stream(const std::vector<std::string>& stream) {
+    std::vector<FixedSymbol<N>> fixed;
+    fixed.reserve(stream.size());
+    for (const auto& s : stream) fixed.emplace_back(s);
+    return fixed;
+}
+
+// sizeof plus the heap block of strings that do not fit the SSO buffer.
+static std::size_t bytes_per_message(const std::vector<std::string>& stream) {
+    std::size_t heap = 0;
+    for (const auto& s : stream) {
+        const char* object = reinterpret_cast<const char*>(&s);
+        if (s.data() < object || s.data() >= object + sizeof(s)) heap += s.capacity() + 1;
+    }
+    return sizeof(std::string) + (stream.empty() ? 0 : heap / stream.size());
+}
+
+
+/* Synthetic listing universe: option-style names longer than the SSO
+ * buffer, so every interned copy is allocated from the registry resource. */
+static std::vector<std::string> generate_symbol_universe(std::size_t n) {
+    std::vector<std::string> universe;
+    universe.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        universe.push_back("OPT" + std::to_string(1'000'000 + i) + "-C-20261218");
+    return universe;
+}
+
+
+/* 1-to-many loops with the fanout fixed at compile time; same bodies as the
+ * runtime-bound loops in TEST 2. */
+template <std::size_t Fanout, typename Sym>
+static std::size_t registry_fanout(SymbolRegistry& registry,
+                                   const std::vector<Sym>& incoming,
+                                   uint32_t target_id) {
+    std::size_t matches = 0;
+    for (const Sym& sym : incoming) {
+        uint32_t incoming_id = registry.get_id(sym);
+        for (std::size_t f = 0; f < Fanout; ++f)
+            if (incoming_id == target_id) ++matches;
+    }
+    return matches;
+}
+
+template <std::size_t Fanout, typename Sym>
+static std::size_t direct_fanout(const std::vector<Sym>& incoming, const Sym& target) {
+    std::size_t matches = 0;
+    for (const Sym& sym : incoming) {
+        for (std::size_t f = 0; f < Fanout; ++f)
+            if (sym == target) ++matches;
+    }
+    return matches;
+}
+
+using FanoutSweep = std::index_sequence<8, 16, 32, 64, 128, 256, 512, 1024>;
+
+template <std::size_t... Fanouts, typename Fn>
+static void for_each_fanout(std::index_sequence<Fanouts...>, Fn&& fn) {
+    (fn(std::integral_constant<std::size_t, Fanouts>{}), ...);
+}
+
+
 static void print_table_row(int w, const std::string& label, double ms, std::size_t matches) {
     std::cout << std::left  << std::setw(w) << label
               << std::right << std::setw(12) << ms
@@ -149,10 +432,29 @@ int main(int argc, char* argv[]) {
     const uint32_t     target_id     = registry.get_id(target_string);
 
     const auto incoming = generate_incoming_stream(ITERATIONS);
+    const Ticker target_fixed(target_string);
+    const auto incoming_fixed = to_fixed_stream<16>(incoming);
+
+    // Unlocked id tables over the pool: std::hash<std::string> vs the
+    // word-wise std::hash<FixedSymbol<16>>.
+    std::unordered_map<std::string, uint32_t> string_ids;
+    std::unordered_map<Ticker, uint32_t>      fixed_ids;
+    for (const auto& sym : SYMBOL_POOL) {
+        string_ids.emplace(sym, registry.get_id(sym));
+        fixed_ids.emplace(Ticker(sym), registry.get_id(sym));
+    }
+
+    std::cout << "Stream element: std::string " << bytes_per_message(incoming)
+              << " B/message (sizeof + heap), FixedSymbol<16> " << sizeof(Ticker)
+              << " B/message\n\n";
 
     volatile std::size_t sink = 0;
     for (const auto& s : incoming) sink += (registry.get_id(s) == target_id) ? 1 : 0;
     for (const auto& s : incoming) sink += (s == target_string) ? 1 : 0;
+    for (const auto& s : incoming_fixed) sink += (registry.get_id(s) == target_id) ? 1 : 0;
+    for (const auto& s : incoming_fixed) sink += (s == target_fixed) ? 1 : 0;
+    for (const auto& s : incoming) sink += (string_ids.find(s)->second == target_id) ? 1 : 0;
+    for (const auto& s : incoming_fixed) sink += (fixed_ids.find(s)->second == target_id) ? 1 : 0;
 
     const int W = 38;
     std::cout << std::fixed << std::setprecision(3);
@@ -184,15 +486,55 @@ int main(int argc, char* argv[]) {
     }
     double ms_b = tb.elapsed_ms();
 
-    if (matches_a != matches_b) {
+    Timer<> tfa;
+    std::size_t matches_fa = 0;
+    for (const Ticker& sym : incoming_fixed) {
+        uint32_t incoming_id = registry.get_id(sym);
+        if (incoming_id == target_id) ++matches_fa;
+    }
+    double ms_fa = tfa.elapsed_ms();
+
+    Timer<> tfb;
+    std::size_t matches_fb = 0;
+    for (const Ticker& sym : incoming_fixed) {
+        if (sym == target_fixed) ++matches_fb;
+    }
+    double ms_fb = tfb.elapsed_ms();
+
+    Timer<> tsh;
+    std::size_t matches_sh = 0;
+    for (const std::string& sym : incoming) {
+        if (string_ids.find(sym)->second == target_id) ++matches_sh;
+    }
+    double ms_sh = tsh.elapsed_ms();
+
+    Timer<> tfh;
+    std::size_t matches_fh = 0;
+    for (const Ticker& sym : incoming_fixed) {
+        if (fixed_ids.find(sym)->second == target_id) ++matches_fh;
+    }
+    double ms_fh = tfh.elapsed_ms();
+
+    if (matches_a != matches_b || matches_fa != matches_a || matches_fb != matches_a
+            || matches_sh != matches_a || matches_fh != matches_a) {
         std::cerr << "ERROR [1-to-1]: match counts differ ("
-                  << matches_a << " vs " << matches_b << ")\n";
+                  << matches_a << ", " << matches_b << ", "
+                  << matches_fa << ", " << matches_fb << ", "
+                  << matches_sh << ", " << matches_fh << ")\n";
         return 1;
     }
     print_table_row(W, "Registry (lookup + ID cmp)", ms_a, matches_a);
     print_table_row(W, "Direct std::string cmp",     ms_b, matches_b);
+    print_table_row(W, "Registry FixedSymbol (lookup + ID)", ms_fa, matches_fa);
+    print_table_row(W, "Direct FixedSymbol cmp",     ms_fb, matches_fb);
+    print_table_row(W, "Hash map std::string key",   ms_sh, matches_sh);
+    print_table_row(W, "Hash map FixedSymbol key",   ms_fh, matches_fh);
     std::cout << std::string(W + 24, '-') << "\n";
     print_speedup(ms_a, ms_b);
+    std::cout << "  FixedSymbol direct is " << std::setprecision(2) << ms_b / ms_fb
+              << "x the speed of std::string direct.\n"
+              << "  FixedSymbol-keyed map is " << ms_sh / ms_fh
+              << "x the speed of the std::string-keyed map.\n" << std::setprecision(3);
 
     /*
      * TEST 2 — 1-to-many  (fanout sweep: 8 → 1024, doubling each step)
@@ -206,6 +548,8 @@ int main(int argc, char* argv[]) {
         double ms_registry;
         double ms_direct;
         std::size_t matches;
+        double ms_registry_fixed;
+        double ms_direct_fixed;
     };
     std::vector<FanoutResult> fanout_results;
 
@@ -216,6 +560,8 @@ int main(int argc, char* argv[]) {
         }
         for (const auto& s : incoming)
             for (std::size_t f = 0; f < fanout; ++f) sink += (s == target_string) ? 1 : 0;
+        for (const auto& s : incoming_fixed)
+            for (std::size_t f = 0; f < fanout; ++f) sink += (s == target_fixed) ? 1 : 0;
 
         std::cout << "\n---> 1-to-many  fanout=" << fanout
                   << "  (one lookup reused across N operations)\n";
@@ -241,17 +587,37 @@ int main(int argc, char* argv[]) {
         }
         double ms_d = td.elapsed_ms();
 
-        if (matches_c != matches_d) {
+        Timer<> tfc;
+        std::size_t matches_fc = 0;
+        for (const Ticker& sym : incoming_fixed) {
+            uint32_t incoming_id = registry.get_id(sym);
+            for (std::size_t f = 0; f < fanout; ++f)
+                if (incoming_id == target_id) ++matches_fc;
+        }
+        double ms_fc = tfc.elapsed_ms();
+
+        Timer<> tfd;
+        std::size_t matches_fd = 0;
+        for (const Ticker& sym : incoming_fixed) {
+            for (std::size_t f = 0; f < fanout; ++f)
+                if (sym == target_fixed) ++matches_fd;
+        }
+        double ms_fd = tfd.elapsed_ms();
+
+        if (matches_c != matches_d || matches_fc != matches_c || matches_fd != matches_c) {
             std::cerr << "ERROR [1-to-many fanout=" << fanout << "]: match counts differ ("
-                      << matches_c << " vs " << matches_d << ")\n";
+                      << matches_c << ", " << matches_d << ", "
+                      << matches_fc << ", " << matches_fd << ")\n";
             return 1;
         }
         print_table_row(W, "Registry (lookup + NxID cmp)", ms_c, matches_c);
         print_table_row(W, "Direct Nxstd::string cmp",     ms_d, matches_d);
+        print_table_row(W, "Registry FixedSymbol (lookup + NxID)", ms_fc, matches_fc);
+        print_table_row(W, "Direct NxFixedSymbol cmp",     ms_fd, matches_fd);
         std::cout << std::string(W + 24, '-') << "\n";
         print_speedup(ms_c, ms_d);
 
-        fanout_results.push_back({fanout, ms_c, ms_d, matches_c});
+        fanout_results.push_back({fanout, ms_c, ms_d, matches_c, ms_fc, ms_fd});
     }
 
     /*  SUMMARY 1-to-many fanout sweep */
@@ -279,6 +645,277 @@ int main(int argc, char* argv[]) {
     }
     std::cout << std::string(SW * 4 + 2 + 12, '-') << "\n";
 
+    /*
+     * TEST 3 — compile-time fanout
+     *   Same 1-to-many loops as TEST 2, instantiated per sweep value so the
+     *   inner loop bound is a constant. Compared against the runtime-bound
+     *   timings of TEST 2.
+     */
+    struct ConstFanoutResult {
+        std::size_t fanout;
+        double ms_registry;
+        double ms_direct;
+        double ms_registry_fixed;
+        double ms_direct_fixed;
+        std::size_t matches[4];
+    };
+    std::vector<ConstFanoutResult> const_results;
+
+    for_each_fanout(FanoutSweep{}, [&](auto fanout_constant) {
+        constexpr std::size_t FANOUT = decltype(fanout_constant)::value;
+        sink += registry_fanout<FANOUT>(registry, incoming, target_id);
+        sink += direct_fanout<FANOUT>(incoming, target_string);
+        sink += direct_fanout<FANOUT>(incoming_fixed, target_fixed);
+
+        ConstFanoutResult r{FANOUT, 0, 0, 0, 0, {}};
+        Timer<> te;
+        r.matches[0] = registry_fanout<FANOUT>(registry, incoming, target_id);
+        r.ms_registry = te.elapsed_ms();
+
+        Timer<> tf;
+        r.matches[1] = direct_fanout<FANOUT>(incoming, target_string);
+        r.ms_direct = tf.elapsed_ms();
+
+        Timer<> tfe;
+        r.matches[2] = registry_fanout<FANOUT>(registry, incoming_fixed, target_id);
+        r.ms_registry_fixed = tfe.elapsed_ms();
+
+        Timer<> tff;
+        r.matches[3] = direct_fanout<FANOUT>(incoming_fixed, target_fixed);
+        r.ms_direct_fixed = tff.elapsed_ms();
+
+        const_results.push_back(r);
+    });
+
+    for (std::size_t i = 0; i < const_results.size(); ++i) {
+        for (std::size_t m : const_results[i].matches) {
+            if (const_results[i].fanout != fanout_results[i].fanout
+                    || m != fanout_results[i].matches) {
+                std::cerr << "ERROR [compile-time fanout=" << const_results[i].fanout
+                          << "]: match counts differ (" << m << " vs "
+                          << fanout_results[i].matches << ")\n";
+                return 1;
+            }
+        }
+    }
+
+    auto print_const_table = [&](const std::string& title, bool fixed) {
+        std::cout << "\n\n--> compile-time fanout, " << title
+                  << "  (template <std::size_t Fanout> vs runtime bound, ms)\n";
+        std::cout << std::right
+                  << std::setw(SW)     << "Fanout"
+                  << std::setw(SW + 2) << "Reg rt"
+                  << std::setw(SW + 2) << "Reg ct"
+                  << std::setw(SW + 2) << "Gain"
+                  << std::setw(SW + 2) << "Dir rt"
+                  << std::setw(SW + 2) << "Dir ct"
+                  << std::setw(SW + 2) << "Gain" << "\n";
+        std::cout << std::string(SW + (SW + 2) * 6, '-') << "\n";
+        for (std::size_t i = 0; i < const_results.size(); ++i) {
+            const FanoutResult&      rt = fanout_results[i];
+            const ConstFanoutResult& ct = const_results[i];
+            const double reg_rt = fixed ? rt.ms_registry_fixed : rt.ms_registry;
+            const double reg_ct = fixed ? ct.ms_registry_fixed : ct.ms_registry;
+            const double dir_rt = fixed ? rt.ms_direct_fixed : rt.ms_direct;
+            const double dir_ct = fixed ? ct.ms_direct_fixed : ct.ms_direct;
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::setw(SW)     << ct.fanout
+                      << std::setw(SW + 2) << reg_rt
+                      << std::setw(SW + 2) << reg_ct
+                      << std::setprecision(2)
+                      << std::setw(SW + 1) << reg_rt / reg_ct << "x"
+                      << std::setprecision(3)
+                      << std::setw(SW + 2) << dir_rt
+                      << std::setw(SW + 2) << dir_ct
+                      << std::setprecision(2)
+                      << std::setw(SW + 1) << dir_rt / dir_ct << "x" << "\n";
+        }
+        std::cout << std::string(SW + (SW + 2) * 6, '-') << "\n";
+    };
+    print_const_table("std::string stream", false);
+    print_const_table("FixedSymbol<16> stream", true);
+    std::cout << "  Gain = runtime-bound / compile-time-bound time.\n";
+
+    /*
+     * TEST 4 — memory resources
+     *   Same registry, different std::pmr::memory_resource behind the map
+     *   nodes, the id vector and the interned strings.
+     */
+    const std::size_t UNIVERSE = 100'000;
+    const auto universe = generate_symbol_universe(UNIVERSE);
+
+    std::cout << "\n\n--> memory resources  (build: " << SYMBOL_POOL.size() + UNIVERSE
+              << " symbols, lookup: " << ITERATIONS << " get_id)\n";
+    std::cout << std::left  << std::setw(W) << "Resource"
+              << std::right << std::setw(12) << "Build (ms)"
+              << std::setw(12) << "Lookup (ms)"
+              << std::setw(12) << "Fixed (ms)"
+              << std::setw(12) << "Matches" << "\n";
+    std::cout << std::string(W + 48, '-') << "\n";
+
+    auto run_resource = [&](const std::string& label, std::pmr::memory_resource* resource) {
+        Timer<> tbuild;
+        SymbolRegistry pmr_registry(resource);
+        for (const auto& sym : SYMBOL_POOL) pmr_registry.get_id(sym);
+        for (const auto& sym : universe)    pmr_registry.get_id(sym);
+        const double ms_build = tbuild.elapsed_ms();
+
+        const uint32_t pmr_target = pmr_registry.get_id(target_string);
+        Timer<> tlookup;
+        std::size_t matches = 0;
+        for (const std::string& sym : incoming)
+            if (pmr_registry.get_id(sym) == pmr_target) ++matches;
+        const double ms_lookup = tlookup.elapsed_ms();
+
+        Timer<> tfixed;
+        std::size_t matches_fixed = 0;
+        for (const Ticker& sym : incoming_fixed)
+            if (pmr_registry.get_id(sym) == pmr_target) ++matches_fixed;
+        const double ms_fixed = tfixed.elapsed_ms();
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::left  << std::setw(W) << label
+                  << std::right << std::setw(12) << ms_build
+                  << std::setw(12) << ms_lookup
+                  << std::setw(12) << ms_fixed
+                  << std::setw(12) << matches << "\n";
+        return matches == matches_fixed ? matches : SIZE_MAX;
+    };
+
+    std::vector<std::size_t> resource_matches;
+    resource_matches.push_back(
+        run_resource("new_delete_resource", std::pmr::new_delete_resource()));
+    {
+        std::pmr::unsynchronized_pool_resource resource;
+        resource_matches.push_back(run_resource("unsynchronized_pool_resource", &resource));
+    }
+    {
+        std::pmr::synchronized_pool_resource resource;
+        resource_matches.push_back(run_resource("synchronized_pool_resource", &resource));
+    }
+    {
+        std::pmr::monotonic_buffer_resource resource;
+        resource_matches.push_back(run_resource("monotonic_buffer_resource", &resource));
+    }
+    std::cout << std::string(W + 48, '-') << "\n";
+    std::cout << "  Fixed = the same lookups over the FixedSymbol<16> stream.\n";
+    for (std::size_t m : resource_matches) {
+        if (m != matches_a) {
+            std::cerr << "ERROR [memory resources]: match counts differ ("
+                      << m << " vs " << matches_a << ")\n";
+            return 1;
+        }
+    }
+
+    /*
+     * TEST 5 — registry metrics
+     *   get_id over the stream on SymbolRegistry and on
+     *   InstrumentedSymbolRegistry, 1 thread and METRIC_THREADS threads
+     *   sharing one registry, std::string and FixedSymbol<16> streams.
+     *   METRIC_REPS repeats, each one off run and one on run back to back
+     *   (order alternated). Times are medians; the overhead is the median
+     *   of the per-repeat on / off ratios, so host drift between repeats
+     *   cancels out.
+     */
+    const unsigned METRIC_THREADS = 4;
+    const int      METRIC_REPS    = 15;
+    struct MetricsRun {
+        double ms;
+        std::size_t matches;
+    };
+    auto run_lookups = [&](auto& reg, const auto& stream, unsigned threads) {
+        for (const auto& sym : SYMBOL_POOL) reg.get_id(sym);
+        const uint32_t reg_target = reg.get_id(target_string);
+        const std::size_t per_thread = stream.size() / threads;
+        std::vector<std::size_t> found(threads, 0);
+        std::vector<std::thread> pool;
+        Timer<> t;
+        for (unsigned i = 0; i < threads; ++i)
+            pool.emplace_back([&, i] {
+                std::size_t m = 0;
+                for (std::size_t k = i * per_thread; k < (i + 1) * per_thread; ++k)
+                    if (reg.get_id(stream[k]) == reg_target) ++m;
+                found[i] = m;
+            });
+        for (auto& th : pool) th.join();
+        MetricsRun r{t.elapsed_ms(), 0};
+        for (std::size_t m : found) r.matches += m;
+        return r;
+    };
+
+    std::cout << "\n\n--> registry metrics  (" << ITERATIONS
+              << " get_id shared by the threads, median of " << METRIC_REPS << ", ms)\n";
+    std::cout << std::right << std::setw(SW) << "Threads"
+              << std::setw(SW + 2) << "Off (ms)"
+              << std::setw(SW + 2) << "On (ms)"
+              << std::setw(SW + 2) << "Overhead"
+              << std::setw(SW + 2) << "Fixed off"
+              << std::setw(SW + 2) << "Fixed on"
+              << std::setw(SW + 2) << "Overhead" << "\n";
+    std::cout << std::string(SW + (SW + 2) * 6, '-') << "\n";
+
+    RegistryMetrics snapshot;
+    auto median = [](std::vector<double> v) {
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        return v[v.size() / 2];
+    };
+    struct MetricsCell {
+        double ms_off, ms_on, overhead;
+    };
+    auto median_of_reps = [&](const auto& stream, unsigned threads, MetricsCell& cell) {
+        std::vector<double> off_ms, on_ms, ratio;
+        bool ok = true;
+        for (int rep = 0; rep < METRIC_REPS; ++rep) {
+            MetricsRun r_off{}, r_on{};
+            auto run_off = [&] { SymbolRegistry reg; r_off = run_lookups(reg, stream, threads); };
+            auto run_on  = [&] {
+                InstrumentedSymbolRegistry reg;
+                r_on = run_lookups(reg, stream, threads);
+                snapshot = reg.metrics();
+            };
+            if (rep % 2 == 0) { run_off(); run_on(); }
+            else              { run_on(); run_off(); }
+            off_ms.push_back(r_off.ms);
+            on_ms.push_back(r_on.ms);
+            ratio.push_back(r_on.ms / r_off.ms);
+            ok &= r_off.matches == r_on.matches && (threads > 1 || r_off.matches == matches_a);
+        }
+        cell = {median(off_ms), median(on_ms), (median(ratio) - 1) * 100};
+        return ok;
+    };
+    for (unsigned threads : {1u, METRIC_THREADS}) {
+        MetricsCell str{}, fixed{};
+        if (!median_of_reps(incoming_fixed, threads, fixed)
+                || !median_of_reps(incoming, threads, str)) {
+            std::cerr << "ERROR [registry metrics threads=" << threads
+                      << "]: match counts differ\n";
+            return 1;
+        }
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(SW)     << threads
+                  << std::setw(SW + 2) << str.ms_off
+                  << std::setw(SW + 2) << str.ms_on
+                  << std::setprecision(2)
+                  << std::setw(SW + 1) << str.overhead << "%"
+                  << std::setprecision(3)
+                  << std::setw(SW + 2) << fixed.ms_off
+                  << std::setw(SW + 2) << fixed.ms_on
+                  << std::setprecision(2)
+                  << std::setw(SW + 1) << fixed.overhead << "%\n";
+    }
+    std::cout << std::string(SW + (SW + 2) * 6, '-') << "\n";
+    std::cout << "  Overhead = median of the per-repeat on / off ratios.\n";
+    std::cout << "  Fixed = the same lookups over the FixedSymbol<16> stream.\n";
+    std::cout << "  Snapshot of the last " << METRIC_THREADS << "-thread run: "
+              << snapshot.lookups << " lookups, " << snapshot.misses << " misses, "
+              << snapshot.inserts << " inserts, " << snapshot.lock_waits << " lock waits, "
+              << snapshot.lock_wait_cycles / std::max<uint64_t>(1, snapshot.lock_waits)
+#if defined(MM_HAS_TSC)
+              << " cycles per wait.\n";
+#else
+              << " ns per wait.\n";
+#endif
+
     std::cout << "\n";
     (void)sink;
     return 0;
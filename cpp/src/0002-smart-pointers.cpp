@@ -8,12 +8,21 @@
  *   3  move-semantics     - std::move with unique_ptr and shared_ptr
  *   4  shared-from-this   - enable_shared_from_this and safe self-shared_ptr
  *   5  ref-counters       - step-by-step use_count and weak ref-count changes
+ *   6  pmr-resources      - allocate_shared and pmr containers on std::pmr
+ *                          memory resources, plus a timed churn comparison
+ *   7  poly-dispatch      - ResourceHandler hierarchy held as shared_ptr<Base>,
+ *                          unique_ptr<Base>, std::variant and a small-buffer
+ *                          type-erased value: build, dispatch and destroy
+ *   8  aliasing           - aliasing constructor for sub-object handles vs a
+ *                          separate make_shared per member vs member copies
  *
  * Usage:
- *   ./0002-smart-pointers <section-number>
+ *   ./0002-smart-pointers <section-number> [iterations]
+ *   iterations is used by the timed sections (default 10 000 000);
+ *   section 8 creates iterations / 10 handles per row
  *
  * Build:
- *   g++ -std=c++17 -O2 -o 0002-smart-pointers 0002-smart-pointers.cpp
+ *   g++ -std=c++17 -O2 -pthread -o 0002-smart-pointers 0002-smart-pointers.cpp
  *
  * Debug:
  *   gdb ./0002-smart-pointers
@@ -25,11 +34,57 @@
  * See (https://github.com/augustodamasceno/micrometrics)
  */
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
-#include <cstdlib>
+
+
+/* Heap call counters for section 8. CountingAllocator is stateless and
+ * forwards to std::allocator, so only the handles built with it are counted;
+ * the global operator new / delete stay the library's own. */
+struct AllocCounters {
+    static uint64_t news;
+    static uint64_t bytes;
+};
+uint64_t AllocCounters::news  = 0;
+uint64_t AllocCounters::bytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        ++AllocCounters::news;
+        AllocCounters::bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const noexcept { return false; }
+};
+
+using CountedString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
 
 
 struct Resource {
@@ -46,12 +101,15 @@ struct Resource {
 };
 
 // Node with enable_shared_from_this for section 4.
+// The children vector allocates from the given memory resource (section 6).
 struct Node : std::enable_shared_from_this<Node> {
     std::string id;
     std::weak_ptr<Node> parent;
-    std::vector<std::shared_ptr<Node>> children;
+    std::pmr::vector<std::shared_ptr<Node>> children;
 
-    explicit Node(std::string i) : id(std::move(i)) {
+    explicit Node(std::string i,
+                  std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : id(std::move(i)), children(mr) {
         std::cout << "  [+] Node(" << id << ")\n";
     }
     ~Node() {
@@ -67,6 +125,93 @@ struct Node : std::enable_shared_from_this<Node> {
 };
 
 
+// Quiet payload for the timed sections: no logging in ctor / dtor.
+struct Payload {
+    uint64_t value;
+    double   weight;
+    explicit Payload(uint64_t v) : value(v), weight(static_cast<double>(v)) {}
+};
+
+// Quiet Resource hierarchy for section 7: event handlers behind a base class.
+struct ResourceHandler {
+    virtual ~ResourceHandler() = default;
+    virtual uint64_t on_event(uint64_t e) = 0;
+};
+
+struct QuoteHandler final : ResourceHandler {
+    uint64_t last = 0;
+    uint64_t on_event(uint64_t e) override { last = e; return last; }
+};
+
+struct TradeHandler final : ResourceHandler {
+    uint64_t volume = 0;
+    uint64_t count  = 0;
+    uint64_t on_event(uint64_t e) override { volume += e; return ++count; }
+};
+
+struct RiskHandler final : ResourceHandler {
+    uint64_t exposure = 0;
+    uint64_t on_event(uint64_t e) override { exposure ^= e * 31; return exposure & 0xff; }
+};
+
+using HandlerVariant = std::variant<QuoteHandler, TradeHandler, RiskHandler>;
+
+/* Small-buffer type-erased handler: any type with on_event(uint64_t) that
+ * fits in CAPACITY bytes is stored inline and called through a static
+ * function table, so there is no heap allocation and no vtable in the
+ * handle itself beyond one pointer. */
+class InlineHandler {
+private:
+    static constexpr std::size_t CAPACITY = 32;
+
+    struct Ops {
+        uint64_t (*on_event)(void*, uint64_t);
+        void     (*move)(void* dst, void* src);
+        void     (*destroy)(void*);
+    };
+
+    template <typename T>
+    static constexpr Ops ops_for = {
+        [](void* p, uint64_t e) { return static_cast<T*>(p)->on_event(e); },
+        [](void* dst, void* src) { ::new (dst) T(std::move(*static_cast<T*>(src))); },
+        [](void* p) { static_cast<T*>(p)->~T(); },
+    };
+
+    alignas(std::max_align_t) unsigned char buf_[CAPACITY];
+    const Ops* ops_;
+
+public:
+    template <typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, InlineHandler>>>
+    explicit InlineHandler(T&& h) : ops_(&ops_for<std::decay_t<T>>) {
+        static_assert(sizeof(std::decay_t<T>) <= CAPACITY, "handler too large for inline buffer");
+        ::new (static_cast<void*>(buf_)) std::decay_t<T>(std::forward<T>(h));
+    }
+    InlineHandler(InlineHandler&& o) noexcept : ops_(o.ops_) { ops_->move(buf_, o.buf_); }
+    InlineHandler(const InlineHandler&) = delete;
+    InlineHandler& operator=(const InlineHandler&) = delete;
+    InlineHandler& operator=(InlineHandler&&) = delete;
+    ~InlineHandler() { ops_->destroy(buf_); }
+
+    uint64_t on_event(uint64_t e) { return ops_->on_event(buf_, e); }
+};
+
+// Quiet reference-data object for section 8. Strings exceed the SSO buffer.
+struct RefData {
+    std::string            name;
+    std::string            isin;
+    std::array<double, 64> curve{};
+    RefData(std::string n, std::string i) : name(std::move(n)), isin(std::move(i)) {}
+};
+
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+
 // 1 ─ Simple creation of unique_ptr, shared_ptr and weak_ptr
 void section_simple_creation() {
     std::cout << "\n--- unique_ptr ---\n";
@@ -321,31 +466,345 @@ void section_shared_from_this() {
     }
 }
 
+// 6 ─ std::pmr memory resources behind smart pointers and containers
+//
+// allocate_shared with a polymorphic_allocator places the object and its
+// control block in one block taken from the resource; pmr containers take
+// their storage from the same resource. The timed part churns BATCH
+// shared_ptr per round into a pmr::vector and drops them again.
+template <typename MemoryResource>
+static double pmr_churn(MemoryResource& resource, std::size_t iterations, uint64_t& sink) {
+    constexpr std::size_t BATCH = 1024;
+    std::pmr::polymorphic_allocator<Payload> alloc(&resource);
+    Timer<> t;
+    for (std::size_t done = 0; done < iterations; done += BATCH) {
+        {
+            std::pmr::vector<std::shared_ptr<Payload>> batch(&resource);
+            batch.reserve(BATCH);
+            for (std::size_t i = 0; i < BATCH; ++i)
+                batch.push_back(std::allocate_shared<Payload>(alloc, done + i));
+            for (const auto& p : batch) sink += p->value;
+        }
+        // A monotonic resource never reuses freed blocks; rewind it per round.
+        if constexpr (std::is_same_v<MemoryResource, std::pmr::monotonic_buffer_resource>)
+            resource.release();
+    }
+    return t.elapsed_ms();
+}
+
+static double std_churn(std::size_t iterations, uint64_t& sink) {
+    constexpr std::size_t BATCH = 1024;
+    Timer<> t;
+    for (std::size_t done = 0; done < iterations; done += BATCH) {
+        std::vector<std::shared_ptr<Payload>> batch;
+        batch.reserve(BATCH);
+        for (std::size_t i = 0; i < BATCH; ++i)
+            batch.push_back(std::make_shared<Payload>(done + i));
+        for (const auto& p : batch) sink += p->value;
+    }
+    return t.elapsed_ms();
+}
+
+void section_pmr_resources(std::size_t iterations) {
+    std::cout << "\n--- allocate_shared on a stack arena (monotonic_buffer_resource) ---\n";
+    {
+        alignas(std::max_align_t) unsigned char buffer[4096];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                  std::pmr::null_memory_resource());
+        {
+            auto sp = std::allocate_shared<Resource>(
+                std::pmr::polymorphic_allocator<Resource>(&arena), "pmr-shared");
+            const auto* addr = reinterpret_cast<const unsigned char*>(sp.get());
+            std::cout << "  object inside arena        : " << std::boolalpha
+                      << (addr >= buffer && addr < buffer + sizeof(buffer)) << "\n";
+            std::cout << "  use_count                  : " << sp.use_count() << "\n";
+        } // object destroyed, block returned to the arena (a no-op for monotonic)
+
+        auto root = std::allocate_shared<Node>(
+            std::pmr::polymorphic_allocator<Node>(&arena), "pmr-root", &arena);
+        root->add_child(std::allocate_shared<Node>(
+            std::pmr::polymorphic_allocator<Node>(&arena), "pmr-child", &arena));
+        std::cout << "  children vector resource   : "
+                  << (root->children.get_allocator().resource() == &arena ? "arena" : "other")
+                  << "\n";
+    } // tree freed before the arena goes out of scope
+
+    std::cout << "\n--- shared_ptr churn per memory resource ---\n";
+    std::cout << "  " << iterations << " allocate_shared, 1024 live per round\n\n";
+
+    const int W = 34;
+    uint64_t sink = 0;
+    auto row = [&](const char* label, double ms) {
+        std::cout << "  " << std::left << std::setw(W) << label
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << ms << " ms"
+                  << std::setw(10) << std::setprecision(2)
+                  << ms * 1e6 / static_cast<double>(iterations) << " ns/op\n";
+    };
+
+    row("std::allocator (make_shared)", std_churn(iterations, sink));
+    {
+        auto* resource = std::pmr::new_delete_resource();
+        row("new_delete_resource", pmr_churn(*resource, iterations, sink));
+    }
+    {
+        std::pmr::unsynchronized_pool_resource resource;
+        row("unsynchronized_pool_resource", pmr_churn(resource, iterations, sink));
+    }
+    {
+        std::pmr::synchronized_pool_resource resource;
+        row("synchronized_pool_resource", pmr_churn(resource, iterations, sink));
+    }
+    {
+        std::pmr::monotonic_buffer_resource resource;
+        row("monotonic_buffer_resource", pmr_churn(resource, iterations, sink));
+    }
+    std::cout << "  (checksum " << sink << ")\n";
+}
+
+// 7 ─ Polymorphic ownership and dispatch
+//
+// The same random sequence of Quote / Trade / Risk handlers stored four
+// ways. Build = allocate + construct + push_back; dispatch = PASSES calls of
+// on_event per handler; destroy = clear() plus freeing the vector.
+// Returns false when the dispatch checksum disagrees with the first storage.
+template <typename Container, typename Make, typename Call>
+static bool poly_run(const char* label, std::size_t element_size,
+                     const std::vector<uint8_t>& kinds, Make make, Call call,
+                     uint64_t& checksum) {
+    constexpr std::size_t PASSES = 5;
+    const std::size_t n = kinds.size();
+
+    Timer<> tb;
+    Container handlers;
+    handlers.reserve(n);
+    for (uint8_t k : kinds) make(handlers, k);
+    const double ms_build = tb.elapsed_ms();
+
+    Timer<> td;
+    uint64_t sum = 0;
+    for (std::size_t pass = 0; pass < PASSES; ++pass)
+        for (auto& h : handlers) sum += call(h, pass + 1);
+    const double ns_dispatch = td.elapsed_ms() * 1e6 / static_cast<double>(n * PASSES);
+
+    Timer<> tx;
+    Container().swap(handlers);
+    const double ms_destroy = tx.elapsed_ms();
+
+    if (checksum == 0) checksum = sum;
+    std::cout << "  " << std::left << std::setw(30) << label
+              << std::right << std::setw(8) << element_size
+              << std::fixed << std::setprecision(3)
+              << std::setw(14) << ms_build
+              << std::setprecision(2)
+              << std::setw(14) << ns_dispatch
+              << std::setprecision(3)
+              << std::setw(14) << ms_destroy << "\n";
+    if (sum != checksum) {
+        std::cerr << "ERROR [poly-dispatch]: " << label << " checksum " << sum
+                  << " != " << checksum << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool section_poly_dispatch(std::size_t iterations) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(0, 2);
+    std::vector<uint8_t> kinds(iterations);
+    for (auto& k : kinds) k = static_cast<uint8_t>(pick(rng));
+
+    std::cout << "\n--- " << iterations << " handlers, random Quote / Trade / Risk mix ---\n\n";
+    std::cout << "  " << std::left << std::setw(30) << "Storage"
+              << std::right << std::setw(8) << "sizeof"
+              << std::setw(14) << "Build (ms)"
+              << std::setw(14) << "Dispatch ns"
+              << std::setw(14) << "Destroy (ms)" << "\n";
+    std::cout << "  " << std::string(80, '-') << "\n";
+
+    uint64_t checksum = 0;
+    bool ok = true;
+
+    ok &= poly_run<std::vector<std::shared_ptr<ResourceHandler>>>(
+        "vector<shared_ptr<Base>>", sizeof(std::shared_ptr<ResourceHandler>), kinds,
+        [](auto& v, uint8_t k) {
+            if (k == 0)      v.push_back(std::make_shared<QuoteHandler>());
+            else if (k == 1) v.push_back(std::make_shared<TradeHandler>());
+            else             v.push_back(std::make_shared<RiskHandler>());
+        },
+        [](auto& h, uint64_t e) { return h->on_event(e); }, checksum);
+
+    ok &= poly_run<std::vector<std::unique_ptr<ResourceHandler>>>(
+        "vector<unique_ptr<Base>>", sizeof(std::unique_ptr<ResourceHandler>), kinds,
+        [](auto& v, uint8_t k) {
+            if (k == 0)      v.push_back(std::make_unique<QuoteHandler>());
+            else if (k == 1) v.push_back(std::make_unique<TradeHandler>());
+            else             v.push_back(std::make_unique<RiskHandler>());
+        },
+        [](auto& h, uint64_t e) { return h->on_event(e); }, checksum);
+
+    ok &= poly_run<std::vector<HandlerVariant>>(
+        "vector<variant<...>>", sizeof(HandlerVariant), kinds,
+        [](auto& v, uint8_t k) {
+            if (k == 0)      v.emplace_back(std::in_place_type<QuoteHandler>);
+            else if (k == 1) v.emplace_back(std::in_place_type<TradeHandler>);
+            else             v.emplace_back(std::in_place_type<RiskHandler>);
+        },
+        [](auto& h, uint64_t e) {
+            return std::visit([e](auto& handler) { return handler.on_event(e); }, h);
+        },
+        checksum);
+
+    ok &= poly_run<std::vector<InlineHandler>>(
+        "vector<InlineHandler> (SBO)", sizeof(InlineHandler), kinds,
+        [](auto& v, uint8_t k) {
+            if (k == 0)      v.emplace_back(QuoteHandler{});
+            else if (k == 1) v.emplace_back(TradeHandler{});
+            else             v.emplace_back(RiskHandler{});
+        },
+        [](auto& h, uint64_t e) { return h.on_event(e); }, checksum);
+    return ok;
+}
+
+// 8 ─ Aliasing constructor: shared ownership of a sub-object
+//
+// shared_ptr<U>(const shared_ptr<T>& owner, U* member) shares owner's
+// control block but points at the member: no allocation, and the whole
+// owner stays alive as long as any alias does. The per-handle copies use
+// CountingAllocator, so the heap columns count exactly their allocations.
+// Returns false when the handle checksum disagrees with the first style.
+template <typename Handle, typename Make>
+static bool aliasing_run(const char* label, const std::vector<std::shared_ptr<RefData>>& owners,
+                         std::size_t handles, Make make, uint64_t& checksum) {
+    const uint64_t news0  = AllocCounters::news;
+    const uint64_t bytes0 = AllocCounters::bytes;
+    Timer<> tc;
+    std::vector<Handle> out;
+    out.reserve(handles);
+    for (std::size_t i = 0; i < handles; ++i) out.push_back(make(owners[i % owners.size()]));
+    const double ms_create = tc.elapsed_ms();
+    const uint64_t news  = AllocCounters::news - news0;
+    const uint64_t bytes = AllocCounters::bytes - bytes0;
+
+    Timer<> tx;
+    std::vector<Handle> copies(out);
+    const double ms_copy = tx.elapsed_ms();
+
+    uint64_t sum = 0;
+    for (const auto& h : copies) {
+        if constexpr (std::is_same_v<Handle, CountedString>) sum += h.size();
+        else                                                  sum += h->size();
+    }
+    if (checksum == 0) checksum = sum;
+
+    std::cout << "  " << std::left << std::setw(30) << label
+              << std::right << std::setw(8) << sizeof(Handle)
+              << std::setw(12) << news
+              << std::setw(14) << bytes / handles
+              << std::fixed << std::setprecision(3)
+              << std::setw(14) << ms_create
+              << std::setw(14) << ms_copy << "\n";
+    if (sum != checksum) {
+        std::cerr << "ERROR [aliasing]: " << label << " checksum " << sum
+                  << " != " << checksum << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool section_aliasing(std::size_t iterations) {
+    std::cout << "\n--- aliasing constructor: handle to a member ---\n";
+    {
+        std::shared_ptr<std::string> name;
+        {
+            auto res = std::make_shared<Resource>("ref-data");
+            name = std::shared_ptr<std::string>(res, &res->name);   // no allocation
+            std::cout << "  use_count (owner + alias)  : " << res.use_count() << "\n"; // 2
+            std::cout << "  alias points at member     : "
+                      << std::boolalpha << (name.get() == &res->name) << "\n";
+        } // res gone; Resource kept alive by the alias
+        std::cout << "  alias still valid          : " << *name << "\n";
+        std::cout << "  use_count (alias only)     : " << name.use_count() << "\n"; // 1
+    } // alias released -> ~Resource
+
+    const std::size_t handles = iterations / 10;   // see usage
+    if (handles == 0) {
+        std::cerr << "ERROR [iterations]: section 8 needs at least 10 iterations\n";
+        return false;
+    }
+    std::vector<std::shared_ptr<RefData>> owners;
+    for (int i = 0; i < 1000; ++i)
+        owners.push_back(std::make_shared<RefData>(
+            "REFDATA-INSTRUMENT-" + std::to_string(100000 + i),
+            "US" + std::to_string(1000000000 + i) + "-XNAS-EQUITY"));
+
+    std::cout << "\n--- " << handles << " name handles over " << owners.size()
+              << " RefData objects ---\n\n";
+    std::cout << "  " << std::left << std::setw(30) << "Handle"
+              << std::right << std::setw(8) << "sizeof"
+              << std::setw(12) << "Heap allocs"
+              << std::setw(14) << "Heap B/handle"
+              << std::setw(14) << "Create (ms)"
+              << std::setw(14) << "Copy (ms)" << "\n";
+    std::cout << "  " << std::string(92, '-') << "\n";
+
+    uint64_t checksum = 0;
+    bool ok = true;
+    ok &= aliasing_run<std::shared_ptr<const std::string>>(
+        "aliasing shared_ptr", owners, handles,
+        [](const std::shared_ptr<RefData>& o) {
+            return std::shared_ptr<const std::string>(o, &o->name);
+        }, checksum);
+    ok &= aliasing_run<std::shared_ptr<const CountedString>>(
+        "allocate_shared per handle", owners, handles,
+        [](const std::shared_ptr<RefData>& o) {
+            return std::shared_ptr<const CountedString>(std::allocate_shared<CountedString>(
+                CountingAllocator<CountedString>(), o->name.data(), o->name.size()));
+        }, checksum);
+    ok &= aliasing_run<CountedString>(
+        "std::string copy (by value)", owners, handles,
+        [](const std::shared_ptr<RefData>& o) {
+            return CountedString(o->name.data(), o->name.size());
+        }, checksum);
+    return ok;
+}
+
 // ---------------------------------------------------------------------------
 // Help menu
 // ---------------------------------------------------------------------------
 void print_help(const char* prog) {
-    std::cout << "\nUsage: " << prog << " <section>\n\n"
+    std::cout << "\nUsage: " << prog << " <section> [iterations]\n\n"
               << "Sections:\n"
               << "  1  simple-creation  - construct unique_ptr, shared_ptr, weak_ptr\n"
               << "  2  double-ownership - UB: two shared_ptr owning the same raw pointer\n"
               << "  3  move-semantics   - std::move with unique_ptr and shared_ptr\n"
               << "  4  shared-from-this - enable_shared_from_this and self shared_ptr\n"
               << "  5  ref-counters     - step-by-step strong and weak ref-count changes\n"
+              << "  6  pmr-resources    - allocate_shared and pmr containers on memory resources\n"
+              << "  7  poly-dispatch    - shared_ptr<Base> vs unique_ptr<Base> vs variant vs SBO value\n"
+              << "  8  aliasing         - aliasing constructor for sub-object handles\n"
+              << "\nIterations (default 10 000 000) drive sections 6-8; section 8 creates\n"
+              << "iterations / 10 handles per row.\n"
               << "\nExample:\n"
-              << "  " << prog << " 1\n\n";
+              << "  " << prog << " 1\n"
+              << "  " << prog << " 6 1000000\n\n";
 }
 
 // ---------------------------------------------------------------------------
 // main- dispatch
 // ---------------------------------------------------------------------------
 int main(int argc, char* argv[]) {
+    // Sections 6-8 time atomic ref counts (cpp/README.md).
+    std::thread([] {}).join();
+
     if (argc < 2) {
         print_help(argv[0]);
         return 1;
     }
 
     int section = std::atoi(argv[1]);
+    const std::size_t iterations =
+        argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 10'000'000;
 
     switch (section) {
         case 1:
@@ -368,6 +827,18 @@ int main(int argc, char* argv[]) {
             std::cout << "   Section 5: ref-counters   \n";
             section_ref_counters();
             break;
+        case 6:
+            std::cout << "   Section 6: pmr-resources   \n";
+            section_pmr_resources(iterations);
+            break;
+        case 7:
+            std::cout << "   Section 7: poly-dispatch   \n";
+            if (!section_poly_dispatch(iterations)) return 1;
+            break;
+        case 8:
+            std::cout << "   Section 8: aliasing   \n";
+            if (!section_aliasing(iterations)) return 1;
+            break;
         default:
             std::cout << "Unknown section: " << argv[1] << "\n";
             print_help(argv[0]);
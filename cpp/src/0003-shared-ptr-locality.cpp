@@ -0,0 +1,344 @@
+/* micrometrics : shared_ptr Cache Locality
+ *
+ * make_shared<T>() places the object and its control block (strong count,
+ * weak count, deleter) in one allocation. shared_ptr<T>(new T) performs two
+ * allocations, so the object and its counts can land on different cache
+ * lines, or different pages once the heap is fragmented.
+ *
+ * Each entry count is built twice into a vector<shared_ptr<Resource>>:
+ *   make_shared      - object + control block colocated
+ *   shared_ptr(new)  - object and control block allocated separately
+ *
+ * Heap layouts
+ *   fresh     - allocated back to back with no deliberate fragmentation
+ *               (the heap still holds what earlier cells freed), traversed
+ *               in order
+ *   shuffled  - same allocation, vector order shuffled before traversal
+ *   aged      - allocator free lists scrambled with random-size blocks
+ *               (half of them freed) before building, then shuffled
+ *
+ * Passes
+ *   read-only  - p->value summed through every pointer (touches object only)
+ *   copy-heavy - every shared_ptr copied into a second vector, then the copies
+ *                are dropped (touches the control block: atomic inc + dec,
+ *                and the object through the read)
+ *
+ * Cache misses are read from perf_event_open (PERF_COUNT_HW_CACHE_MISSES)
+ * on Linux when the kernel allows it (perf_event_paranoid <= 2 and a PMU is
+ * exposed); otherwise the column shows n/a.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0003-shared-ptr-locality 0003-shared-ptr-locality.cpp
+ *
+ * Run:
+ *   ./0003-shared-ptr-locality [max_entries]
+ *   default: max_entries=50 000 000
+ *   entries are swept over 1M, 2M, 5M, 10M, 20M, 50M up to max_entries
+ *   (at least 1M)
+ *   Peak RSS grows about 205 B per entry (1 GB at 5M), so the default 50M
+ *   needs about 10 GB: the aged layout allocates n filler blocks of 16-256 B
+ *   and keeps half alive while the entries and the copies vector are live.
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// Quiet position-like object: no logging, 48 bytes of payload.
+struct Resource {
+    std::string name;
+    double      value;
+    uint64_t    quantity;
+
+    Resource(std::string n, double v, uint64_t q)
+        : name(std::move(n)), value(v), quantity(q) {}
+};
+
+
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+/* Hardware cache-miss counter for the calling thread. stop() returns -1 when
+ * the counter could not be opened (non-Linux, no PMU, or perf disabled). */
+class CacheMissCounter {
+private:
+    int fd_ = -1;
+
+public:
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long stop() {
+#if defined(__linux__)
+        if (fd_ < 0) return -1;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+            return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+};
+
+
+enum class Factory { MakeShared, SharedNew };
+enum class Layout  { Fresh, Shuffled, Aged };
+
+static const char* factory_name(Factory f) {
+    return f == Factory::MakeShared ? "make_shared" : "shared_ptr(new)";
+}
+
+static const char* layout_name(Layout l) {
+    switch (l) {
+        case Layout::Fresh:    return "fresh";
+        case Layout::Shuffled: return "shuffled";
+        case Layout::Aged:     return "aged";
+    }
+    return "?";
+}
+
+/* Scramble the allocator free lists: allocate n blocks of 16..256 bytes and
+ * free a random half. Later allocations are served from the resulting holes,
+ * which are scattered across the heap. The surviving blocks are returned so
+ * the caller keeps them alive until the measurement is done. */
+static std::vector<std::unique_ptr<char[]>>
+age_heap(std::size_t n, std::mt19937& rng) {
+    std::uniform_int_distribution<std::size_t> size(16, 256);
+    std::vector<std::unique_ptr<char[]>> blocks;
+    blocks.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        blocks.emplace_back(new char[size(rng)]);
+    std::shuffle(blocks.begin(), blocks.end(), rng);
+    blocks.resize(n / 2);
+    return blocks;
+}
+
+static std::vector<std::shared_ptr<Resource>>
+build(std::size_t n, Factory factory) {
+    std::vector<std::shared_ptr<Resource>> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (factory == Factory::MakeShared)
+            v.push_back(std::make_shared<Resource>("POS", static_cast<double>(i), i));
+        else
+            v.push_back(std::shared_ptr<Resource>(
+                new Resource("POS", static_cast<double>(i), i)));
+    }
+    return v;
+}
+
+struct PassResult {
+    double    ms_build;
+    double    ms_read;
+    double    ms_copy;
+    long long misses_read;
+    long long misses_copy;
+};
+
+static PassResult run(std::size_t n, Factory factory, Layout layout, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::vector<std::unique_ptr<char[]>> filler;
+    if (layout == Layout::Aged)
+        filler = age_heap(n, rng);
+
+    PassResult r{};
+    Timer<> tb;
+    auto v = build(n, factory);
+    r.ms_build = tb.elapsed_ms();
+
+    if (layout != Layout::Fresh)
+        std::shuffle(v.begin(), v.end(), rng);
+
+    CacheMissCounter counter;
+    volatile double sink = 0.0;
+
+    counter.start();
+    Timer<> tr;
+    double sum = 0.0;
+    for (const auto& p : v) sum += p->value;
+    r.ms_read = tr.elapsed_ms();
+    r.misses_read = counter.stop();
+    sink = sink + sum;
+
+    std::vector<std::shared_ptr<Resource>> copies;
+    copies.reserve(n);
+    counter.start();
+    Timer<> tc;
+    for (const auto& p : v) copies.push_back(p);
+    sum = 0.0;
+    for (const auto& p : copies) sum += p->value;
+    copies.clear();
+    r.ms_copy = tc.elapsed_ms();
+    r.misses_copy = counter.stop();
+    sink = sink + sum;
+
+    (void)sink;
+    return r;
+}
+
+
+static std::string format_misses(long long m) {
+    return m < 0 ? "n/a" : std::to_string(m);
+}
+
+int main(int argc, char* argv[]) {
+    // The copy-heavy pass times atomic ref counts (cpp/README.md).
+    std::thread([] {}).join();
+
+    const std::size_t MAX_ENTRIES =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 50'000'000;
+
+    const std::vector<std::size_t> SWEEP = {
+        1'000'000, 2'000'000, 5'000'000, 10'000'000, 20'000'000, 50'000'000,
+    };
+    if (MAX_ENTRIES < SWEEP.front()) {
+        std::cerr << "ERROR [max_entries]: " << MAX_ENTRIES << " is below the smallest cell ("
+                  << SWEEP.front() << ")\n";
+        return 1;
+    }
+
+    CacheMissCounter probe;
+    std::cout << "micrometrics - shared_ptr cache locality (make_shared vs shared_ptr(new))\n"
+              << "Max entries     : " << MAX_ENTRIES << "\n"
+              << "sizeof(Resource): " << sizeof(Resource) << " bytes\n"
+              << "Cache counters  : " << (probe.available() ? "perf_event_open" : "n/a")
+              << "\n";
+
+    const int FW = 18;
+    const int LW = 10;
+    const int CW = 12;
+    const int MW = 14;
+    const int TOTAL = FW + LW + CW * 5 + MW * 2;
+
+    struct Row {
+        std::size_t n;
+        Layout      layout;
+        double      read_ns_make;
+        double      read_ns_new;
+        double      copy_ns_make;
+        double      copy_ns_new;
+    };
+    std::vector<Row> summary;
+
+    for (std::size_t n : SWEEP) {
+        if (n > MAX_ENTRIES) break;
+
+        std::cout << "\n---> entries=" << n << "\n";
+        std::cout << std::left  << std::setw(FW) << "Factory"
+                  << std::setw(LW) << "Layout"
+                  << std::right << std::setw(CW) << "Build (ms)"
+                  << std::setw(CW) << "Read (ms)"
+                  << std::setw(CW) << "Copy (ms)"
+                  << std::setw(CW) << "Read ns/e"
+                  << std::setw(CW) << "Copy ns/e"
+                  << std::setw(MW) << "Read miss"
+                  << std::setw(MW) << "Copy miss" << "\n";
+        std::cout << std::string(TOTAL, '-') << "\n";
+
+        for (Layout layout : {Layout::Fresh, Layout::Shuffled, Layout::Aged}) {
+            Row row{n, layout, 0.0, 0.0, 0.0, 0.0};
+            for (Factory factory : {Factory::MakeShared, Factory::SharedNew}) {
+                const PassResult r = run(n, factory, layout);
+                const double read_ns = r.ms_read * 1e6 / static_cast<double>(n);
+                const double copy_ns = r.ms_copy * 1e6 / static_cast<double>(n);
+                std::cout << std::fixed << std::setprecision(3)
+                          << std::left  << std::setw(FW) << factory_name(factory)
+                          << std::setw(LW) << layout_name(layout)
+                          << std::right << std::setw(CW) << r.ms_build
+                          << std::setw(CW) << r.ms_read
+                          << std::setw(CW) << r.ms_copy
+                          << std::setprecision(2)
+                          << std::setw(CW) << read_ns
+                          << std::setw(CW) << copy_ns
+                          << std::setw(MW) << format_misses(r.misses_read)
+                          << std::setw(MW) << format_misses(r.misses_copy) << "\n";
+                if (factory == Factory::MakeShared) {
+                    row.read_ns_make = read_ns;
+                    row.copy_ns_make = copy_ns;
+                } else {
+                    row.read_ns_new = read_ns;
+                    row.copy_ns_new = copy_ns;
+                }
+            }
+            summary.push_back(row);
+        }
+        std::cout << std::string(TOTAL, '-') << "\n";
+    }
+
+    /* SUMMARY  speedup of make_shared over shared_ptr(new), per pass */
+    std::cout << "\n\n--> summary (shared_ptr(new) time / make_shared time)\n";
+    const int SW = 12;
+    std::cout << std::right
+              << std::setw(SW) << "Entries"
+              << std::setw(SW) << "Layout"
+              << std::setw(SW) << "Read"
+              << std::setw(SW) << "Copy" << "\n";
+    std::cout << std::string(SW * 4, '-') << "\n";
+    for (const auto& r : summary) {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(SW) << r.n
+                  << std::setw(SW) << layout_name(r.layout)
+                  << std::setw(SW) << r.read_ns_new / r.read_ns_make
+                  << std::setw(SW) << r.copy_ns_new / r.copy_ns_make << "\n";
+    }
+    std::cout << std::string(SW * 4, '-') << "\n";
+
+    std::cout << "\n";
+    return 0;
+}
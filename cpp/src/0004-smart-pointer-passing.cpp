@@ -0,0 +1,310 @@
+/* micrometrics : Smart Pointer Parameter Passing
+ *
+ * Cost of handing a pointer down a call chain of depth 1..16, where every
+ * level is a real (non-inlined) call and the leaf reads the object.
+ *
+ * Passing modes
+ *   shared value   - f(std::shared_ptr<T> p)   copy at every level:
+ *                                              atomic inc + dec per level
+ *   shared cref    - f(const std::shared_ptr<T>& p)   no ref-count traffic
+ *   shared move    - f(std::shared_ptr<T> p) with std::move at every level,
+ *                    the pointer is returned back up the chain so the caller
+ *                    keeps ownership; no ref-count traffic
+ *   unique rref    - f(std::unique_ptr<T>&& p) without moving out
+ *   unique ref     - f(std::unique_ptr<T>& p)
+ *   raw T*         - f(T* p)
+ *
+ * Every chain runs single-threaded and then with N threads hammering the
+ * same object (and so the same control block). Under contention the
+ * "shared value" chain bounces the control-block cache line between cores.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0004-smart-pointer-passing 0004-smart-pointer-passing.cpp
+ *
+ * Run:
+ *   ./0004-smart-pointer-passing [iterations] [threads]
+ *   default: iterations=10 000 000 chain calls per thread per cell
+ *            threads=std::thread::hardware_concurrency() (at least 2);
+ *            a given threads value below 1 is raised to 1
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/* Keep every level of the chain a real call. GCC's noipa also stops it from
+ * cloning the function or proving it pure and hoisting it out of the loop. */
+#if defined(__clang__)
+#define MM_NOINLINE __attribute__((noinline))
+#elif defined(__GNUC__)
+#define MM_NOINLINE __attribute__((noipa))
+#elif defined(_MSC_VER)
+#define MM_NOINLINE __declspec(noinline)
+#else
+#define MM_NOINLINE
+#endif
+
+
+struct Resource {
+    std::string name;
+    uint64_t    quantity;
+
+    Resource(std::string n, uint64_t q) : name(std::move(n)), quantity(q) {}
+};
+
+// Everything a chain may start from: one object, owned both ways.
+struct Owner {
+    std::shared_ptr<Resource> shared = std::make_shared<Resource>("shared", 1);
+    std::unique_ptr<Resource> unique = std::make_unique<Resource>("unique", 1);
+};
+
+
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+static inline uint64_t leaf(const Resource& r) {
+    // Compiler barrier: the chain must not be treated as a pure function.
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    return r.quantity;
+}
+
+
+/* Each mode exposes a chain<Depth>() and a loop<Depth>() that runs the chain
+ * `iterations` times starting from the shared Owner. */
+struct SharedValue {
+    static constexpr const char* name = "shared value";
+
+    template <int Depth>
+    static MM_NOINLINE uint64_t chain(std::shared_ptr<Resource> p) {
+        if constexpr (Depth == 1) return leaf(*p);
+        else                      return chain<Depth - 1>(p);
+    }
+
+    template <int Depth>
+    static uint64_t loop(Owner& owner, std::size_t iterations) {
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < iterations; ++i) acc += chain<Depth>(owner.shared);
+        return acc;
+    }
+};
+
+struct SharedConstRef {
+    static constexpr const char* name = "shared cref";
+
+    template <int Depth>
+    static MM_NOINLINE uint64_t chain(const std::shared_ptr<Resource>& p) {
+        if constexpr (Depth == 1) return leaf(*p);
+        else                      return chain<Depth - 1>(p);
+    }
+
+    template <int Depth>
+    static uint64_t loop(Owner& owner, std::size_t iterations) {
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < iterations; ++i) acc += chain<Depth>(owner.shared);
+        return acc;
+    }
+};
+
+struct SharedMove {
+    static constexpr const char* name = "shared move";
+
+    template <int Depth>
+    static MM_NOINLINE std::shared_ptr<Resource>
+    chain(std::shared_ptr<Resource> p, uint64_t& acc) {
+        if constexpr (Depth == 1) {
+            acc += leaf(*p);
+            return p;
+        } else {
+            return chain<Depth - 1>(std::move(p), acc);
+        }
+    }
+
+    template <int Depth>
+    static uint64_t loop(Owner& owner, std::size_t iterations) {
+        uint64_t acc = 0;
+        std::shared_ptr<Resource> local = owner.shared;   // one copy, outside the loop
+        for (std::size_t i = 0; i < iterations; ++i)
+            local = chain<Depth>(std::move(local), acc);
+        return acc;
+    }
+};
+
+struct UniqueRvalueRef {
+    static constexpr const char* name = "unique rref";
+
+    template <int Depth>
+    static MM_NOINLINE uint64_t chain(std::unique_ptr<Resource>&& p) {
+        if constexpr (Depth == 1) return leaf(*p);
+        else                      return chain<Depth - 1>(std::move(p));
+    }
+
+    template <int Depth>
+    static uint64_t loop(Owner& owner, std::size_t iterations) {
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < iterations; ++i)
+            acc += chain<Depth>(std::move(owner.unique));   // never moved from
+        return acc;
+    }
+};
+
+struct UniqueRef {
+    static constexpr const char* name = "unique ref";
+
+    template <int Depth>
+    static MM_NOINLINE uint64_t chain(std::unique_ptr<Resource>& p) {
+        if constexpr (Depth == 1) return leaf(*p);
+        else                      return chain<Depth - 1>(p);
+    }
+
+    template <int Depth>
+    static uint64_t loop(Owner& owner, std::size_t iterations) {
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < iterations; ++i) acc += chain<Depth>(owner.unique);
+        return acc;
+    }
+};
+
+struct RawPointer {
+    static constexpr const char* name = "raw T*";
+
+    template <int Depth>
+    static MM_NOINLINE uint64_t chain(Resource* p) {
+        if constexpr (Depth == 1) return leaf(*p);
+        else                      return chain<Depth - 1>(p);
+    }
+
+    template <int Depth>
+    static uint64_t loop(Owner& owner, std::size_t iterations) {
+        uint64_t acc = 0;
+        Resource* raw = owner.unique.get();
+        for (std::size_t i = 0; i < iterations; ++i) acc += chain<Depth>(raw);
+        return acc;
+    }
+};
+
+
+constexpr int MAX_DEPTH = 16;
+
+/* Run Mode::loop<Depth> on `threads` threads at once and return the wall
+ * time in ns per chain call, as seen by one thread. */
+template <typename Mode, int Depth>
+static double measure(Owner& owner, std::size_t iterations, unsigned threads,
+                      uint64_t& sink) {
+    if (threads <= 1) {
+        Timer<> t;
+        sink += Mode::template loop<Depth>(owner, iterations);
+        return t.elapsed_ms() * 1e6 / static_cast<double>(iterations);
+    }
+
+    std::atomic<bool>     go{false};
+    std::atomic<unsigned> ready{0};
+    std::vector<uint64_t> results(threads, 0);
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1, std::memory_order_relaxed);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            results[t] = Mode::template loop<Depth>(owner, iterations);
+        });
+    }
+    while (ready.load(std::memory_order_relaxed) < threads) std::this_thread::yield();
+
+    Timer<> t;
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    const double ms = t.elapsed_ms();
+
+    for (uint64_t r : results) sink += r;
+    return ms * 1e6 / static_cast<double>(iterations);
+}
+
+template <typename Mode, std::size_t... Is>
+static double measure_depth(int depth, Owner& owner, std::size_t iterations,
+                            unsigned threads, uint64_t& sink,
+                            std::index_sequence<Is...>) {
+    using Fn = double (*)(Owner&, std::size_t, unsigned, uint64_t&);
+    static constexpr std::array<Fn, sizeof...(Is)> table = {
+        &measure<Mode, static_cast<int>(Is) + 1>...
+    };
+    return table[static_cast<std::size_t>(depth - 1)](owner, iterations, threads, sink);
+}
+
+template <typename... Modes>
+static void print_matrix(const std::string& title, Owner& owner,
+                         std::size_t iterations, unsigned threads, uint64_t& sink) {
+    const int DW = 8;
+    const int CW = 14;
+    const int TOTAL = DW + CW * static_cast<int>(sizeof...(Modes));
+
+    std::cout << "\n---> " << title << "  (ns per chain call)\n";
+    std::cout << std::right << std::setw(DW) << "Depth";
+    ((std::cout << std::setw(CW) << Modes::name), ...);
+    std::cout << "\n" << std::string(TOTAL, '-') << "\n";
+
+    for (int depth = 1; depth <= MAX_DEPTH; ++depth) {
+        std::cout << std::setw(DW) << depth << std::fixed << std::setprecision(2);
+        ((std::cout << std::setw(CW)
+                    << measure_depth<Modes>(depth, owner, iterations, threads, sink,
+                                            std::make_index_sequence<MAX_DEPTH>{})),
+         ...);
+        std::cout << "\n";
+    }
+    std::cout << std::string(TOTAL, '-') << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // The 1-thread matrix times atomic ref counts too (cpp/README.md).
+    std::thread([] {}).join();
+
+    const std::size_t ITERATIONS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 10'000'000;
+    const unsigned THREADS =
+        argc > 2 ? static_cast<unsigned>(std::max(1, std::atoi(argv[2])))
+                 : std::max(2u, std::thread::hardware_concurrency());
+
+    std::cout << "micrometrics - smart pointer parameter passing through call chains\n"
+              << "Iterations : " << ITERATIONS << " calls per thread per cell\n"
+              << "Depths     : 1 to " << MAX_DEPTH << "\n"
+              << "Threads    : 1 and " << THREADS << " (contended, same object)\n";
+
+    Owner owner;
+    uint64_t sink = 0;
+
+    print_matrix<SharedValue, SharedConstRef, SharedMove, UniqueRvalueRef, UniqueRef, RawPointer>(
+        "single-threaded", owner, ITERATIONS, 1, sink);
+    print_matrix<SharedValue, SharedConstRef, SharedMove, UniqueRvalueRef, UniqueRef, RawPointer>(
+        "contended x" + std::to_string(THREADS), owner, ITERATIONS, THREADS, sink);
+
+    // Every leaf returns quantity == 1, so the total is fully predictable.
+    const uint64_t expected = static_cast<uint64_t>(ITERATIONS) * MAX_DEPTH * 6 * (1 + THREADS);
+    if (sink != expected) {
+        std::cerr << "ERROR: leaf sum " << sink << " != expected " << expected << "\n";
+        return 1;
+    }
+
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,441 @@
+/* micrometrics : Recycling Object Pool
+ *
+ * ObjectPool<T> hands out std::unique_ptr<T, PoolReturn<T>>. The deleter
+ * destroys the object and pushes its storage onto the releasing thread's
+ * free list instead of calling operator delete, so a steady acquire/release
+ * cycle never reaches the heap.
+ *
+ * Design
+ *   - PoolReturn<T> is stateless, so the handle stays pointer-sized.
+ *   - Free slots are an intrusive singly linked list (the next pointer lives
+ *     in the slot storage of a dead object).
+ *   - Each thread caches free slots in a thread_local list. When a thread
+ *     releases more than FLUSH_AT slots (typical for a consumer that only
+ *     releases), a batch of BATCH slots moves to a mutex-protected depot.
+ *     A thread whose list is empty takes a batch from the depot and only
+ *     allocates a new slab of BATCH slots when the depot is empty too.
+ *     That is the pool-to-pool handoff for objects released on another
+ *     thread: they return to the acquiring side one batch (one lock) at a
+ *     time.
+ *   - One pool per T per process; slabs are freed at exit.
+ *
+ * Heap calls are counted by replacing the global operator new / delete,
+ * aligned overloads included, so the counters cover everything in the
+ * process, including make_unique and the over-aligned SPSC ring.
+ *
+ * Scenarios
+ *   [churn]    acquire, use, release in a tight loop   (live set = 1)
+ *   [window]   ring of WINDOW live objects, oldest released per acquire
+ *   [handoff]  producer acquires, consumer thread uses and releases,
+ *              pointers passed through a fixed SPSC ring (no heap)
+ *   Each scenario runs once to warm up, then is timed; heap calls are the
+ *   counter delta over the timed run, so the scenario's own setup shows up
+ *   as a constant: 2 for the window vector, 4 for the handoff SPSC ring and
+ *   the consumer's std::thread state. Target rate is 10M ops/s.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0005-object-pool 0005-object-pool.cpp
+ *
+ * Run:
+ *   ./0005-object-pool [iterations]
+ *   default: iterations=10 000 000
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------
+// Process-wide heap call counters (replaced global operator new / delete)
+// ---------------------------------------------------------------------------
+struct AllocCounters {
+    static std::atomic<uint64_t> news;
+    static std::atomic<uint64_t> deletes;
+
+    static uint64_t total() {
+        return news.load(std::memory_order_relaxed) + deletes.load(std::memory_order_relaxed);
+    }
+};
+std::atomic<uint64_t> AllocCounters::news{0};
+std::atomic<uint64_t> AllocCounters::deletes{0};
+
+/* Kept out of line: once malloc and free are both inlined into a container,
+ * GCC flags the pair as mismatched with the operator new that returned it. */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+static void* counted_malloc(std::size_t size) {
+    AllocCounters::news.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+static void counted_free(void* p) noexcept {
+    if (!p) return;
+    AllocCounters::deletes.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void* operator new(std::size_t size)   { return counted_malloc(size); }
+void* operator new[](std::size_t size) { return counted_malloc(size); }
+void operator delete(void* p) noexcept   { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept   { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete[](p); }
+
+// Over-aligned types (alignas > __STDCPP_DEFAULT_NEW_ALIGNMENT__) land here.
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+static void* counted_aligned_malloc(std::size_t size, std::align_val_t align) {
+    AllocCounters::news.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t a = static_cast<std::size_t>(align);
+    const std::size_t rounded = ((size ? size : 1) + a - 1) / a * a;   // aligned_alloc needs a multiple
+    if (void* p = std::aligned_alloc(a, rounded)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t al)   { return counted_aligned_malloc(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return counted_aligned_malloc(size, al); }
+void operator delete(void* p, std::align_val_t) noexcept   { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+
+
+// ---------------------------------------------------------------------------
+// ObjectPool
+// ---------------------------------------------------------------------------
+template <typename T>
+class ObjectPool;
+
+template <typename T>
+struct PoolReturn {
+    void operator()(T* p) const noexcept { ObjectPool<T>::release(p); }
+};
+
+template <typename T>
+class ObjectPool {
+public:
+    using Handle = std::unique_ptr<T, PoolReturn<T>>;
+
+    static constexpr std::size_t BATCH    = 256;
+    static constexpr std::size_t FLUSH_AT = 2 * BATCH;
+
+    template <typename... Args>
+    static Handle acquire(Args&&... args) {
+        LocalCache& cache = local();
+        if (!cache.head) refill(cache);
+        Slot* slot = cache.head;
+        cache.head = slot->next;
+        --cache.count;
+        return Handle(::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...));
+    }
+
+    static void release(T* p) noexcept {
+        p->~T();
+        Slot* slot = reinterpret_cast<Slot*>(p);
+        LocalCache& cache = local();
+        slot->next = cache.head;
+        cache.head = slot;
+        if (++cache.count >= FLUSH_AT) flush(cache, BATCH);
+    }
+
+    static std::size_t slabs() {
+        Depot& d = depot();
+        std::lock_guard<std::mutex> lock(d.mtx);
+        return d.slabs.size();
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Batch {
+        Slot*       head;
+        std::size_t count;
+    };
+
+    struct Depot {
+        std::mutex                           mtx;
+        std::vector<Batch>                   batches;
+        std::vector<std::unique_ptr<Slot[]>> slabs;
+        Depot() {
+            batches.reserve(1024);
+            slabs.reserve(1024);
+        }
+    };
+
+    struct LocalCache {
+        Slot*       head  = nullptr;
+        std::size_t count = 0;
+        ~LocalCache() { if (count) flush(*this, count); }   // hand back on thread exit
+    };
+
+    static Depot& depot() {
+        static Depot d;
+        return d;
+    }
+
+    static LocalCache& local() {
+        thread_local LocalCache cache;
+        return cache;
+    }
+
+    // Move `n` slots from the head of the local list into one depot batch.
+    static void flush(LocalCache& cache, std::size_t n) {
+        Batch batch{cache.head, n};
+        Slot* tail = cache.head;
+        for (std::size_t i = 1; i < n; ++i) tail = tail->next;
+        cache.head = tail->next;
+        cache.count -= n;
+        tail->next = nullptr;
+
+        Depot& d = depot();
+        std::lock_guard<std::mutex> lock(d.mtx);
+        d.batches.push_back(batch);
+    }
+
+    // Local list is empty: take a depot batch, or carve a new slab.
+    static void refill(LocalCache& cache) {
+        Depot& d = depot();
+        std::unique_lock<std::mutex> lock(d.mtx);
+        if (!d.batches.empty()) {
+            Batch batch = d.batches.back();
+            d.batches.pop_back();
+            cache.head  = batch.head;
+            cache.count = batch.count;
+            return;
+        }
+        d.slabs.emplace_back(new Slot[BATCH]);
+        Slot* slab = d.slabs.back().get();
+        lock.unlock();
+
+        for (std::size_t i = 0; i + 1 < BATCH; ++i) slab[i].next = &slab[i + 1];
+        slab[BATCH - 1].next = nullptr;
+        cache.head  = slab;
+        cache.count = BATCH;
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+// Order-like payload. Name stays within SSO so construction never allocates.
+struct Resource {
+    std::string name;
+    double      price;
+    uint64_t    quantity;
+
+    Resource(std::string n, double p, uint64_t q) : name(std::move(n)), price(p), quantity(q) {}
+};
+
+using PooledResource = ObjectPool<Resource>::Handle;
+
+
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+struct MakeUniqueFactory {
+    static constexpr const char* name = "make_unique";
+    using Handle = std::unique_ptr<Resource>;
+    static Handle make(uint64_t i) {
+        return std::make_unique<Resource>("ORD", static_cast<double>(i), i);
+    }
+};
+
+struct PoolFactory {
+    static constexpr const char* name = "ObjectPool";
+    using Handle = PooledResource;
+    static Handle make(uint64_t i) {
+        return ObjectPool<Resource>::acquire("ORD", static_cast<double>(i), i);
+    }
+};
+
+template <typename H>
+static inline uint64_t use(H& h) {
+    h->quantity += 1;
+    return h->quantity + static_cast<uint64_t>(h->price);
+}
+
+template <typename Factory>
+static uint64_t churn(std::size_t iterations) {
+    uint64_t acc = 0;
+    for (std::size_t i = 0; i < iterations; ++i) {
+        auto h = Factory::make(i);
+        acc += use(h);
+    }
+    return acc;
+}
+
+constexpr std::size_t WINDOW = 4096;
+
+template <typename Factory>
+static uint64_t window(std::size_t iterations) {
+    std::vector<typename Factory::Handle> ring(WINDOW);
+    uint64_t acc = 0;
+    for (std::size_t i = 0; i < iterations; ++i) {
+        auto& slot = ring[i % WINDOW];
+        slot = Factory::make(i);              // releases the oldest object
+        acc += use(slot);
+    }
+    return acc;
+}
+
+/* Single-producer / single-consumer ring of raw pointers. Fixed storage, so
+ * the hand-off path itself never touches the heap. */
+template <typename P, std::size_t N>
+class SpscRing {
+private:
+    std::array<P, N>         buf_{};
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+
+public:
+    void push(P p) {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        while (t - head_.load(std::memory_order_acquire) == N) std::this_thread::yield();
+        buf_[t % N] = p;
+        tail_.store(t + 1, std::memory_order_release);
+    }
+    P pop() {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        while (tail_.load(std::memory_order_acquire) == h) std::this_thread::yield();
+        P p = buf_[h % N];
+        head_.store(h + 1, std::memory_order_release);
+        return p;
+    }
+};
+
+template <typename Factory>
+static uint64_t handoff(std::size_t iterations) {
+    using Handle = typename Factory::Handle;
+    using Ptr    = typename Handle::pointer;
+    auto ring = std::make_unique<SpscRing<Ptr, 1024>>();
+
+    uint64_t consumed = 0;
+    std::thread consumer([&] {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Handle h(ring->pop());            // adopt; released on this thread
+            consumed += use(h);
+        }
+    });
+    for (std::size_t i = 0; i < iterations; ++i)
+        ring->push(Factory::make(i).release());
+    consumer.join();
+    return consumed;
+}
+
+struct Result {
+    double   ms;
+    uint64_t heap_calls;
+};
+
+template <typename Factory, typename Scenario>
+static Result measure(Scenario scenario, std::size_t iterations, uint64_t& sink) {
+    sink += scenario(iterations);            // warm-up: fills pool / malloc caches
+    const uint64_t before = AllocCounters::total();
+    Timer<> t;
+    sink += scenario(iterations);
+    const double ms = t.elapsed_ms();
+    return {ms, AllocCounters::total() - before};
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t ITERATIONS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 10'000'000;
+    const double TARGET_MOPS = 10.0;
+
+    std::cout << "micrometrics - recycling object pool vs make_unique\n"
+              << "Iterations     : " << ITERATIONS << "\n"
+              << "sizeof(handle) : make_unique " << sizeof(std::unique_ptr<Resource>)
+              << " B, ObjectPool " << sizeof(PooledResource) << " B\n"
+              << "Target rate    : " << TARGET_MOPS << " M ops/s\n";
+
+    const int NW = 26;
+    const int CW = 14;
+    const int TOTAL = NW + CW * 5;
+    uint64_t sink = 0;
+
+    auto report = [&](const std::string& title, const Result& mu, const Result& pool) {
+        std::cout << "\n---> " << title << "\n";
+        std::cout << std::left  << std::setw(NW) << "Method"
+                  << std::right << std::setw(CW) << "Time (ms)"
+                  << std::setw(CW) << "ns/op"
+                  << std::setw(CW) << "M ops/s"
+                  << std::setw(CW) << "Heap calls"
+                  << std::setw(CW) << "Calls/op" << "\n";
+        std::cout << std::string(TOTAL, '-') << "\n";
+        for (const auto& [name, r] : {std::pair<const char*, Result>{MakeUniqueFactory::name, mu},
+                                      std::pair<const char*, Result>{PoolFactory::name, pool}}) {
+            const double ns   = r.ms * 1e6 / static_cast<double>(ITERATIONS);
+            const double mops = static_cast<double>(ITERATIONS) / (r.ms * 1e3);
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::left  << std::setw(NW) << name
+                      << std::right << std::setw(CW) << r.ms
+                      << std::setprecision(2)
+                      << std::setw(CW) << ns
+                      << std::setw(CW) << mops
+                      << std::setw(CW) << r.heap_calls
+                      << std::setprecision(4)
+                      << std::setw(CW) << static_cast<double>(r.heap_calls) / static_cast<double>(ITERATIONS)
+                      << (mops >= TARGET_MOPS ? "" : "  (below target)") << "\n";
+        }
+        std::cout << std::string(TOTAL, '-') << "\n";
+        const double speedup = mu.ms / pool.ms;
+        if (speedup >= 1.0)
+            std::cout << "  ObjectPool is " << std::fixed << std::setprecision(2)
+                      << speedup << "x faster than make_unique.\n";
+        else
+            std::cout << "  make_unique is " << std::fixed << std::setprecision(2)
+                      << (1.0 / speedup) << "x faster than ObjectPool.\n";
+    };
+
+    report("churn  (acquire, use, release; live set = 1)",
+           measure<MakeUniqueFactory>(churn<MakeUniqueFactory>, ITERATIONS, sink),
+           measure<PoolFactory>(churn<PoolFactory>, ITERATIONS, sink));
+
+    report("window  (" + std::to_string(WINDOW) + " live objects, oldest released)",
+           measure<MakeUniqueFactory>(window<MakeUniqueFactory>, ITERATIONS, sink),
+           measure<PoolFactory>(window<PoolFactory>, ITERATIONS, sink));
+
+    report("handoff  (producer acquires, consumer thread releases)",
+           measure<MakeUniqueFactory>(handoff<MakeUniqueFactory>, ITERATIONS, sink),
+           measure<PoolFactory>(handoff<PoolFactory>, ITERATIONS, sink));
+
+    std::cout << "\nPool slabs allocated: " << ObjectPool<Resource>::slabs()
+              << " x " << ObjectPool<Resource>::BATCH << " objects\n\n";
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,403 @@
+/* micrometrics : Persistent Map on Shared Nodes
+ *
+ * Risk snapshots keep one map per version. Copying a std::map or
+ * std::unordered_map per version costs O(N); a persistent (structurally
+ * shared) map makes a new version by copying only the path from the root
+ * to the changed entry and sharing every other node with the old version.
+ *
+ * PersistentMap<V, Ptrs> is a hash array mapped trie (HAMT, CHAMP
+ * layout): 32-way nodes, one bitmap for inline entries and one for child
+ * nodes, 5 hash bits per level. Keys are 64-bit and hashed with the
+ * splitmix64 finaliser, which is a bijection, so distinct keys never
+ * collide and no collision nodes are needed.
+ *
+ * Node ownership policies
+ *   SharedPtrs     - std::shared_ptr<const Node> via make_shared
+ *   IntrusivePtrs  - IntrusivePtr<const Node>, the count lives in the node
+ *                    (one allocation, one word per node, no weak count)
+ *
+ * Scenarios, per entry count (1K, 10K, 100K, 1M)
+ *   build     - insert N keys, one version per insert for the persistent
+ *               maps, in place for the std maps
+ *   update    - VERSIONS versions, each = snapshot of the previous one +
+ *               UPDATES_PER_VERSION random updates; the last HISTORY
+ *               versions stay alive. For the std maps the snapshot is a full
+ *               copy. Reported per version.
+ *   snapshot  - cost of the snapshot alone (root pointer copy vs map copy)
+ *   lookup    - random lookups on the latest version, ns per lookup
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0006-persistent-map 0006-persistent-map.cpp
+ *
+ * Run:
+ *   ./0006-persistent-map [versions] [max_entries]
+ *   default: versions=100  max_entries=1 000 000
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------
+// Node ownership policies
+// ---------------------------------------------------------------------------
+
+// Intrusive reference count. Copying a node must not copy its count.
+struct RefCounted {
+    mutable std::atomic<uint32_t> refs{0};
+
+    RefCounted() = default;
+    RefCounted(const RefCounted&) : refs(0) {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+
+    void add_ref() const { refs.fetch_add(1, std::memory_order_relaxed); }
+    bool release() const { return refs.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+};
+
+template <typename T>
+class IntrusivePtr {
+private:
+    T* p_ = nullptr;
+
+public:
+    IntrusivePtr() = default;
+    explicit IntrusivePtr(T* p) : p_(p) { if (p_) p_->add_ref(); }
+    IntrusivePtr(const IntrusivePtr& o) : p_(o.p_) { if (p_) p_->add_ref(); }
+    IntrusivePtr(IntrusivePtr&& o) noexcept : p_(o.p_) { o.p_ = nullptr; }
+    ~IntrusivePtr() { if (p_ && p_->release()) delete p_; }
+
+    IntrusivePtr& operator=(IntrusivePtr o) noexcept {
+        std::swap(p_, o.p_);
+        return *this;
+    }
+
+    T* get() const { return p_; }
+    T& operator*() const { return *p_; }
+    T* operator->() const { return p_; }
+    explicit operator bool() const { return p_ != nullptr; }
+};
+
+struct SharedPtrs {
+    static constexpr const char* name = "HAMT shared_ptr";
+    struct NodeBase {};
+    template <typename T> using Ptr = std::shared_ptr<const T>;
+    template <typename T, typename... Args>
+    static Ptr<T> make(Args&&... args) { return std::make_shared<const T>(std::forward<Args>(args)...); }
+};
+
+struct IntrusivePtrs {
+    static constexpr const char* name = "HAMT intrusive";
+    using NodeBase = RefCounted;
+    template <typename T> using Ptr = IntrusivePtr<const T>;
+    template <typename T, typename... Args>
+    static Ptr<T> make(Args&&... args) { return Ptr<T>(new T(std::forward<Args>(args)...)); }
+};
+
+
+// ---------------------------------------------------------------------------
+// PersistentMap
+// ---------------------------------------------------------------------------
+template <typename V, typename Ptrs>
+class PersistentMap {
+private:
+    static constexpr unsigned BITS = 5;
+    static constexpr uint32_t MASK = (1u << BITS) - 1;
+
+    struct Entry {
+        uint64_t key;
+        V        value;
+    };
+
+    struct Node;
+    using NodePtr = typename Ptrs::template Ptr<Node>;
+
+    struct Node : Ptrs::NodeBase {
+        uint32_t             datamap = 0;   // slot holds an inline entry
+        uint32_t             nodemap = 0;   // slot holds a child node
+        std::vector<Entry>   entries;       // in slot order
+        std::vector<NodePtr> children;      // in slot order
+    };
+
+    NodePtr     root_;
+    std::size_t size_ = 0;
+
+    PersistentMap(NodePtr root, std::size_t size) : root_(std::move(root)), size_(size) {}
+
+    static uint64_t hash(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static unsigned slot(uint64_t h, unsigned shift) {
+        return static_cast<unsigned>(h >> shift) & MASK;
+    }
+
+    static unsigned index(uint32_t map, uint32_t bit) {
+        return static_cast<unsigned>(std::bitset<32>(map & (bit - 1)).count());
+    }
+
+    // Node holding two entries whose hashes agree below `shift`.
+    static NodePtr merge(const Entry& a, uint64_t ha, const Entry& b, uint64_t hb, unsigned shift) {
+        Node n;
+        const unsigned sa = slot(ha, shift);
+        const unsigned sb = slot(hb, shift);
+        if (sa == sb) {
+            n.nodemap = 1u << sa;
+            n.children.push_back(merge(a, ha, b, hb, shift + BITS));
+        } else {
+            n.datamap = (1u << sa) | (1u << sb);
+            if (sa < sb) n.entries = {a, b};
+            else         n.entries = {b, a};
+        }
+        return Ptrs::template make<Node>(std::move(n));
+    }
+
+    // Path copy: returns the new node, sets `added` when the key was absent.
+    static NodePtr insert(const Node* node, uint64_t h, const Entry& e,
+                          unsigned shift, bool& added) {
+        Node n;
+        if (node) n = *node;
+        const uint32_t bit = 1u << slot(h, shift);
+
+        if (n.datamap & bit) {
+            const unsigned pos = index(n.datamap, bit);
+            if (n.entries[pos].key == e.key) {
+                n.entries[pos].value = e.value;
+            } else {
+                const Entry old = n.entries[pos];
+                n.entries.erase(n.entries.begin() + pos);
+                n.datamap &= ~bit;
+                n.nodemap |= bit;
+                n.children.insert(n.children.begin() + index(n.nodemap, bit),
+                                  merge(old, hash(old.key), e, h, shift + BITS));
+                added = true;
+            }
+        } else if (n.nodemap & bit) {
+            const unsigned pos = index(n.nodemap, bit);
+            n.children[pos] = insert(n.children[pos].get(), h, e, shift + BITS, added);
+        } else {
+            n.datamap |= bit;
+            n.entries.insert(n.entries.begin() + index(n.datamap, bit), e);
+            added = true;
+        }
+        return Ptrs::template make<Node>(std::move(n));
+    }
+
+public:
+    PersistentMap() = default;
+
+    // New version with key set to value; this version is unchanged.
+    PersistentMap set(uint64_t key, V value) const {
+        bool added = false;
+        NodePtr root = insert(root_.get(), hash(key), Entry{key, std::move(value)}, 0, added);
+        return PersistentMap(std::move(root), size_ + (added ? 1 : 0));
+    }
+
+    const V* find(uint64_t key) const {
+        const uint64_t h = hash(key);
+        const Node* node = root_.get();
+        for (unsigned shift = 0; node; shift += BITS) {
+            const uint32_t bit = 1u << slot(h, shift);
+            if (node->datamap & bit) {
+                const Entry& e = node->entries[index(node->datamap, bit)];
+                return e.key == key ? &e.value : nullptr;
+            }
+            if (!(node->nodemap & bit)) return nullptr;
+            node = node->children[index(node->nodemap, bit)].get();
+        }
+        return nullptr;
+    }
+
+    std::size_t size() const { return size_; }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+constexpr std::size_t UPDATES_PER_VERSION = 16;
+constexpr std::size_t HISTORY             = 4;
+constexpr std::size_t LOOKUPS             = 1'000'000;
+
+struct Result {
+    double ms_build;
+    double ns_version;     // snapshot + UPDATES_PER_VERSION updates
+    double ns_snapshot;
+    double ns_lookup;
+    double checksum;
+};
+
+// Persistent maps: a version is just another PersistentMap value.
+template <typename Map>
+static Result run_persistent(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& updates,
+                             const std::vector<uint64_t>& probes, std::size_t versions) {
+    Result r{};
+    Timer<> tb;
+    Map map;
+    for (uint64_t k : keys) map = map.set(k, static_cast<double>(k));
+    r.ms_build = tb.elapsed_ms();
+
+    std::deque<Map> history;
+    Timer<> tv;
+    std::size_t u = 0;
+    for (std::size_t v = 0; v < versions; ++v) {
+        Map next = map;                                      // snapshot
+        for (std::size_t i = 0; i < UPDATES_PER_VERSION; ++i, ++u)
+            next = next.set(updates[u], static_cast<double>(v));
+        history.push_back(map);
+        if (history.size() > HISTORY) history.pop_front();
+        map = std::move(next);
+    }
+    r.ns_version = tv.elapsed_ms() * 1e6 / static_cast<double>(versions);
+
+    Timer<> ts;
+    for (std::size_t v = 0; v < versions; ++v) {
+        history.push_back(map);
+        history.pop_front();
+    }
+    r.ns_snapshot = ts.elapsed_ms() * 1e6 / static_cast<double>(versions);
+
+    Timer<> tl;
+    for (uint64_t k : probes)
+        if (const double* p = map.find(k)) r.checksum += *p;
+    r.ns_lookup = tl.elapsed_ms() * 1e6 / static_cast<double>(probes.size());
+    return r;
+}
+
+// std maps: a version is a full copy of the previous one.
+template <typename Map>
+static Result run_copy(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& updates,
+                       const std::vector<uint64_t>& probes, std::size_t versions) {
+    Result r{};
+    Timer<> tb;
+    Map map;
+    for (uint64_t k : keys) map[k] = static_cast<double>(k);
+    r.ms_build = tb.elapsed_ms();
+
+    std::deque<Map> history;
+    Timer<> tv;
+    std::size_t u = 0;
+    for (std::size_t v = 0; v < versions; ++v) {
+        Map next = map;                                      // snapshot
+        for (std::size_t i = 0; i < UPDATES_PER_VERSION; ++i, ++u)
+            next[updates[u]] = static_cast<double>(v);
+        history.push_back(std::move(map));
+        if (history.size() > HISTORY) history.pop_front();
+        map = std::move(next);
+    }
+    r.ns_version = tv.elapsed_ms() * 1e6 / static_cast<double>(versions);
+
+    Timer<> ts;
+    for (std::size_t v = 0; v < versions; ++v) {
+        history.push_back(map);
+        history.pop_front();
+    }
+    r.ns_snapshot = ts.elapsed_ms() * 1e6 / static_cast<double>(versions);
+
+    Timer<> tl;
+    for (uint64_t k : probes) {
+        auto it = map.find(k);
+        if (it != map.end()) r.checksum += it->second;
+    }
+    r.ns_lookup = tl.elapsed_ms() * 1e6 / static_cast<double>(probes.size());
+    return r;
+}
+
+
+int main(int argc, char* argv[]) {
+    // Shared snapshots time atomic ref counts (cpp/README.md).
+    std::thread([] {}).join();
+
+    const std::size_t VERSIONS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 100;
+    const std::size_t MAX_ENTRIES =
+        argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 1'000'000;
+
+    std::cout << "micrometrics - persistent HAMT vs copy-per-version std maps\n"
+              << "Versions   : " << VERSIONS << " x " << UPDATES_PER_VERSION
+              << " updates, last " << HISTORY << " kept alive\n"
+              << "Lookups    : " << LOOKUPS << " on the latest version\n";
+
+    const int NW = 22;
+    const int CW = 16;
+    const int TOTAL = NW + CW * 4;
+
+    for (std::size_t n = 1'000; n <= MAX_ENTRIES; n *= 10) {
+        std::mt19937_64 rng(42);
+        std::vector<uint64_t> keys(n);
+        for (auto& k : keys) k = rng();
+        std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+        std::vector<uint64_t> updates(VERSIONS * UPDATES_PER_VERSION);
+        for (auto& k : updates) k = keys[pick(rng)];
+        std::vector<uint64_t> probes(LOOKUPS);
+        for (auto& k : probes) k = keys[pick(rng)];
+
+        std::cout << "\n---> entries=" << n << "\n";
+        std::cout << std::left  << std::setw(NW) << "Map"
+                  << std::right << std::setw(CW) << "Build (ms)"
+                  << std::setw(CW) << "Version (ns)"
+                  << std::setw(CW) << "Snapshot (ns)"
+                  << std::setw(CW) << "Lookup (ns)" << "\n";
+        std::cout << std::string(TOTAL, '-') << "\n";
+
+        const std::pair<const char*, Result> rows[] = {
+            {SharedPtrs::name,
+             run_persistent<PersistentMap<double, SharedPtrs>>(keys, updates, probes, VERSIONS)},
+            {IntrusivePtrs::name,
+             run_persistent<PersistentMap<double, IntrusivePtrs>>(keys, updates, probes, VERSIONS)},
+            {"std::map copy",
+             run_copy<std::map<uint64_t, double>>(keys, updates, probes, VERSIONS)},
+            {"std::unordered_map copy",
+             run_copy<std::unordered_map<uint64_t, double>>(keys, updates, probes, VERSIONS)},
+        };
+
+        for (const auto& [name, r] : rows) {
+            if (r.checksum != rows[0].second.checksum) {
+                std::cerr << "ERROR [entries=" << n << "]: " << name
+                          << " lookup checksum differs\n";
+                return 1;
+            }
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::left  << std::setw(NW) << name
+                      << std::right << std::setw(CW) << r.ms_build
+                      << std::setprecision(1)
+                      << std::setw(CW) << r.ns_version
+                      << std::setw(CW) << r.ns_snapshot
+                      << std::setprecision(2)
+                      << std::setw(CW) << r.ns_lookup << "\n";
+        }
+        std::cout << std::string(TOTAL, '-') << "\n";
+    }
+
+    std::cout << "\n";
+    return 0;
+}
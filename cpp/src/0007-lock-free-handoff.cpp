@@ -0,0 +1,340 @@
+/* micrometrics : Lock-free unique_ptr Hand-off
+ *
+ * Passing message ownership between threads through
+ *   LockFreeStack<T>  - Treiber stack, MPMC
+ *   MpscQueue<T>      - Vyukov intrusive queue, many producers, one consumer
+ *   MutexDeque<T>     - std::mutex + std::deque<std::unique_ptr<T>>
+ * All three take std::unique_ptr<T> on push and hand it back on pop.
+ *
+ * ABA protection
+ *   Link nodes live in a fixed NodePool and are addressed by 32-bit index.
+ *   Every list head is a 64-bit word = (tag << 32) | (index + 1), and the
+ *   tag is bumped on each successful CAS, so a head that was popped and
+ *   pushed back in between no longer compares equal. Because the pool is
+ *   never freed while the structure is alive, a thread that raced with a
+ *   recycle only reads a stale `next` (an atomic) before its CAS fails; no
+ *   hazard pointers are needed. A single 64-bit CAS keeps it lock-free on
+ *   every mainstream target, unlike a 128-bit pointer+tag pair.
+ *   The pool has a fixed capacity: push yields while every node is in use.
+ *
+ * Scenario
+ *   P producers (1, 2, 4, ... up to N) push pre-allocated messages, one
+ *   consumer pops until it has seen them all. Messages are created before
+ *   the clock starts, so only the hand-off is timed.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0007-lock-free-handoff 0007-lock-free-handoff.cpp
+ *
+ * Run:
+ *   ./0007-lock-free-handoff [messages] [max_producers]
+ *   default: messages=2 000 000 per cell
+ *            max_producers=std::thread::hardware_concurrency() (at least 4)
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------
+// Tagged index stack over a fixed node pool
+// ---------------------------------------------------------------------------
+constexpr uint32_t NIL = UINT32_MAX;
+
+template <typename T>
+struct PoolNode {
+    std::atomic<uint32_t> next{NIL};
+    T*                    payload = nullptr;
+};
+
+/* Treiber stack of node indices. The head packs a 32-bit ABA tag above the
+ * index (+1 so that 0 means empty). */
+template <typename T>
+class TaggedIndexStack {
+private:
+    alignas(64) std::atomic<uint64_t> head_{0};
+    PoolNode<T>* nodes_;
+
+    static uint64_t pack(uint32_t index, uint32_t tag) {
+        return (static_cast<uint64_t>(tag) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+    static uint32_t index_of(uint64_t word) { return static_cast<uint32_t>(word) - 1; }
+    static uint32_t tag_of(uint64_t word)   { return static_cast<uint32_t>(word >> 32); }
+
+public:
+    explicit TaggedIndexStack(PoolNode<T>* nodes) : nodes_(nodes) {}
+
+    void push(uint32_t index) {
+        uint64_t old = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            nodes_[index].next.store(static_cast<uint32_t>(old) == 0 ? NIL : index_of(old),
+                                     std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(old, pack(index, tag_of(old) + 1),
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    uint32_t pop() {
+        uint64_t old = head_.load(std::memory_order_acquire);
+        for (;;) {
+            if (static_cast<uint32_t>(old) == 0) return NIL;
+            const uint32_t top  = index_of(old);
+            const uint32_t next = nodes_[top].next.load(std::memory_order_relaxed);
+            const uint64_t desired =
+                next == NIL ? (static_cast<uint64_t>(tag_of(old) + 1) << 32)
+                            : pack(next, tag_of(old) + 1);
+            if (head_.compare_exchange_weak(old, desired,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire))
+                return top;
+        }
+    }
+};
+
+// Fixed set of link nodes shared by one structure; free nodes on a tagged stack.
+template <typename T>
+class NodePool {
+private:
+    std::unique_ptr<PoolNode<T>[]> nodes_;
+    TaggedIndexStack<T>            free_;
+
+public:
+    explicit NodePool(std::size_t capacity)
+        : nodes_(new PoolNode<T>[capacity]), free_(nodes_.get()) {
+        for (std::size_t i = capacity; i-- > 0;) free_.push(static_cast<uint32_t>(i));
+    }
+
+    PoolNode<T>& operator[](uint32_t i) { return nodes_[i]; }
+    PoolNode<T>* data() { return nodes_.get(); }
+
+    uint32_t acquire() {
+        uint32_t i;
+        while ((i = free_.pop()) == NIL) std::this_thread::yield();   // pool exhausted
+        return i;
+    }
+    void release(uint32_t i) { free_.push(i); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Hand-off structures
+// ---------------------------------------------------------------------------
+template <typename T>
+class LockFreeStack {
+private:
+    NodePool<T>         pool_;
+    TaggedIndexStack<T> items_;
+
+public:
+    static constexpr const char* name = "LockFreeStack";
+
+    explicit LockFreeStack(std::size_t capacity) : pool_(capacity), items_(pool_.data()) {}
+
+    ~LockFreeStack() {
+        for (uint32_t i; (i = items_.pop()) != NIL;) delete pool_[i].payload;
+    }
+
+    void push(std::unique_ptr<T> item) {
+        const uint32_t i = pool_.acquire();
+        pool_[i].payload = item.release();
+        items_.push(i);
+    }
+
+    std::unique_ptr<T> pop() {
+        const uint32_t i = items_.pop();
+        if (i == NIL) return nullptr;
+        std::unique_ptr<T> item(pool_[i].payload);
+        pool_.release(i);
+        return item;
+    }
+};
+
+/* Vyukov MPSC queue. push is a single exchange on the tail (wait-free for
+ * the producer apart from pool exhaustion); only one thread may pop. */
+template <typename T>
+class MpscQueue {
+private:
+    NodePool<T>                       pool_;
+    alignas(64) std::atomic<uint32_t> tail_;
+    alignas(64) uint32_t              head_;   // consumer-owned dummy node
+
+public:
+    static constexpr const char* name = "MpscQueue";
+
+    explicit MpscQueue(std::size_t capacity) : pool_(capacity + 1) {
+        const uint32_t stub = pool_.acquire();
+        pool_[stub].next.store(NIL, std::memory_order_relaxed);
+        tail_.store(stub, std::memory_order_relaxed);
+        head_ = stub;
+    }
+
+    ~MpscQueue() {
+        while (pop()) {}
+    }
+
+    void push(std::unique_ptr<T> item) {
+        const uint32_t i = pool_.acquire();
+        pool_[i].payload = item.release();
+        pool_[i].next.store(NIL, std::memory_order_relaxed);
+        const uint32_t prev = tail_.exchange(i, std::memory_order_acq_rel);
+        pool_[prev].next.store(i, std::memory_order_release);
+    }
+
+    std::unique_ptr<T> pop() {
+        const uint32_t next = pool_[head_].next.load(std::memory_order_acquire);
+        if (next == NIL) return nullptr;
+        std::unique_ptr<T> item(pool_[next].payload);
+        pool_.release(head_);
+        head_ = next;
+        return item;
+    }
+};
+
+template <typename T>
+class MutexDeque {
+private:
+    std::mutex                     mtx_;
+    std::deque<std::unique_ptr<T>> items_;
+
+public:
+    static constexpr const char* name = "mutex + deque";
+
+    explicit MutexDeque(std::size_t) {}
+
+    void push(std::unique_ptr<T> item) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        items_.push_back(std::move(item));
+    }
+
+    std::unique_ptr<T> pop() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (items_.empty()) return nullptr;
+        std::unique_ptr<T> item = std::move(items_.front());
+        items_.pop_front();
+        return item;
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+struct Message {
+    uint64_t sequence;
+    uint64_t producer;
+    double   price;
+};
+
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+constexpr std::size_t CAPACITY = 65'536;
+
+/* P producers push `messages` in total; one consumer pops them all.
+ * Returns M messages per second, or a negative value on a lost message. */
+template <typename Channel>
+static double handoff(std::size_t messages, unsigned producers) {
+    const std::size_t per_producer = messages / producers;
+    const std::size_t total = per_producer * producers;
+
+    std::vector<std::vector<std::unique_ptr<Message>>> outbox(producers);
+    uint64_t expected = 0;
+    for (unsigned p = 0; p < producers; ++p) {
+        outbox[p].reserve(per_producer);
+        for (std::size_t i = 0; i < per_producer; ++i) {
+            outbox[p].push_back(std::make_unique<Message>(Message{i, p, 1.0}));
+            expected += i;
+        }
+    }
+    std::vector<std::unique_ptr<Message>> inbox;
+    inbox.reserve(total);
+
+    Channel channel(CAPACITY);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (auto& m : outbox[p]) channel.push(std::move(m));
+        });
+    }
+
+    Timer<> t;
+    go.store(true, std::memory_order_release);
+    while (inbox.size() < total) {
+        if (auto m = channel.pop()) inbox.push_back(std::move(m));
+        else                        std::this_thread::yield();
+    }
+    const double ms = t.elapsed_ms();
+    for (auto& th : threads) th.join();
+
+    uint64_t received = 0;
+    for (const auto& m : inbox) received += m->sequence;
+    if (received != expected) return -1.0;
+    return static_cast<double>(total) / (ms * 1e3);
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t MESSAGES =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+    const unsigned MAX_PRODUCERS =
+        argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                 : std::max(4u, std::thread::hardware_concurrency());
+
+    std::cout << "micrometrics - unique_ptr hand-off: lock-free stack / MPSC queue vs mutex deque\n"
+              << "Messages   : " << MESSAGES << " per cell, 1 consumer\n"
+              << "Capacity   : " << CAPACITY << " nodes (lock-free structures)\n"
+              << "Lock-free  : 64-bit tagged head = "
+              << std::boolalpha << std::atomic<uint64_t>{}.is_lock_free() << "\n";
+
+    const int PW = 12;
+    const int CW = 18;
+    const int TOTAL = PW + CW * 3;
+    std::cout << "\n---> hand-off rate (M messages/s)\n";
+    std::cout << std::right << std::setw(PW) << "Producers"
+              << std::setw(CW) << LockFreeStack<Message>::name
+              << std::setw(CW) << MpscQueue<Message>::name
+              << std::setw(CW) << MutexDeque<Message>::name << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    for (unsigned p = 1; p <= MAX_PRODUCERS; p *= 2) {
+        const double stack = handoff<LockFreeStack<Message>>(MESSAGES, p);
+        const double queue = handoff<MpscQueue<Message>>(MESSAGES, p);
+        const double mutex = handoff<MutexDeque<Message>>(MESSAGES, p);
+        if (stack < 0 || queue < 0 || mutex < 0) {
+            std::cerr << "ERROR [producers=" << p << "]: messages lost or duplicated\n";
+            return 1;
+        }
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(PW) << p
+                  << std::setw(CW) << stack
+                  << std::setw(CW) << queue
+                  << std::setw(CW) << mutex << "\n";
+    }
+    std::cout << std::string(TOTAL, '-') << "\n\n";
+    return 0;
+}
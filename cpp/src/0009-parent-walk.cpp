@@ -0,0 +1,270 @@
+/* micrometrics : Parent Walk - weak_ptr::lock vs raw back-pointer vs arena
+ *
+ * Node::parent in 0002 is a std::weak_ptr, so every upward step pays a CAS
+ * loop on the strong count in lock() and an atomic decrement when the
+ * previous shared_ptr is released. Three representations of the same tree:
+ *
+ *   weak_ptr lock   - children owned by shared_ptr, parent is weak_ptr;
+ *                     a step is parent.lock()
+ *   raw Node*       - children owned by unique_ptr, parent is a raw pointer.
+ *                     Lifetime rule: a node is owned only by its parent, so
+ *                     it cannot outlive it and its parent pointer is valid
+ *                     for as long as the node itself. Walkers must not hold
+ *                     nodes across a structural change (no shared ownership
+ *                     to keep a detached subtree alive).
+ *   arena index     - all nodes in one vector, parent is a 32-bit index;
+ *                     the arena owns everything, nodes are never freed
+ *                     individually
+ *
+ * Tree shape
+ *   LEAVES root-to-leaf paths of exactly `depth` hops; each path branches
+ *   off the previous one at a random depth, so paths share prefixes and the
+ *   nodes near the root are shared by every walk (and every thread).
+ *   Depth is swept over 16, 64, 256, 1024.
+ *
+ * Threads
+ *   1, 2, 4, ... N threads each walk every leaf to the root at the same
+ *   time. Reported: ns per hop seen by one thread.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0009-parent-walk 0009-parent-walk.cpp
+ *
+ * Run:
+ *   ./0009-parent-walk [passes] [max_threads]
+ *   default: passes=10 (walks of every leaf per thread per cell)
+ *            max_threads=std::thread::hardware_concurrency() (at least 4)
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+constexpr uint32_t NIL = UINT32_MAX;
+
+struct SharedNode {
+    uint64_t                                 value;
+    std::weak_ptr<SharedNode>                parent;
+    std::vector<std::shared_ptr<SharedNode>> children;
+    explicit SharedNode(uint64_t v) : value(v) {}
+};
+
+struct RawNode {
+    uint64_t                              value;
+    RawNode*                              parent = nullptr;
+    std::vector<std::unique_ptr<RawNode>> children;
+    explicit RawNode(uint64_t v) : value(v) {}
+};
+
+struct ArenaNode {
+    uint64_t value;
+    uint32_t parent;
+};
+
+
+// Parent index of every node (node 0 is the root) and the leaf of each path.
+struct Shape {
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> leaves;
+};
+
+constexpr std::size_t LEAVES = 1024;
+
+static Shape make_shape(std::size_t depth, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> branch(0, depth - 1);
+    Shape s;
+    s.parent.push_back(NIL);
+    std::vector<uint32_t> path{0};
+    for (std::size_t l = 0; l < LEAVES; ++l) {
+        path.resize(l == 0 ? 1 : branch(rng) + 1);
+        while (path.size() < depth + 1) {
+            const uint32_t id = static_cast<uint32_t>(s.parent.size());
+            s.parent.push_back(path.back());
+            path.push_back(id);
+        }
+        s.leaves.push_back(path.back());
+    }
+    return s;
+}
+
+struct Trees {
+    std::shared_ptr<SharedNode>              shared_root;
+    std::vector<std::shared_ptr<SharedNode>> shared_leaves;
+    std::unique_ptr<RawNode>                 raw_root;
+    std::vector<RawNode*>                    raw_leaves;
+    std::vector<ArenaNode>                   arena;
+    std::vector<uint32_t>                    arena_leaves;
+};
+
+static Trees build(const Shape& s) {
+    Trees t;
+    const std::size_t n = s.parent.size();
+    std::vector<std::shared_ptr<SharedNode>> shared(n);   // build-time handles only
+    std::vector<RawNode*>                    raw(n);
+
+    shared[0]  = std::make_shared<SharedNode>(0);
+    t.raw_root = std::make_unique<RawNode>(0);
+    raw[0]     = t.raw_root.get();
+    t.arena.reserve(n);
+    t.arena.push_back({0, NIL});
+
+    for (std::size_t i = 1; i < n; ++i) {
+        const uint32_t p = s.parent[i];
+
+        shared[i] = std::make_shared<SharedNode>(i);
+        shared[i]->parent = shared[p];
+        shared[p]->children.push_back(shared[i]);
+
+        auto rn = std::make_unique<RawNode>(i);
+        rn->parent = raw[p];
+        raw[i] = rn.get();
+        raw[p]->children.push_back(std::move(rn));
+
+        t.arena.push_back({i, p});
+    }
+
+    t.shared_root = shared[0];
+    for (uint32_t leaf : s.leaves) {
+        t.shared_leaves.push_back(shared[leaf]);
+        t.raw_leaves.push_back(raw[leaf]);
+        t.arena_leaves.push_back(leaf);
+    }
+    return t;
+}
+
+
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+struct WeakWalk {
+    static constexpr const char* name = "weak_ptr lock";
+    static uint64_t walk(const Trees& t, std::size_t passes) {
+        uint64_t sum = 0;
+        for (std::size_t p = 0; p < passes; ++p)
+            for (const auto& leaf : t.shared_leaves) {
+                std::shared_ptr<SharedNode> node = leaf;
+                while (auto parent = node->parent.lock()) {
+                    sum += parent->value;
+                    node = std::move(parent);
+                }
+            }
+        return sum;
+    }
+};
+
+struct RawWalk {
+    static constexpr const char* name = "raw Node*";
+    static uint64_t walk(const Trees& t, std::size_t passes) {
+        uint64_t sum = 0;
+        for (std::size_t p = 0; p < passes; ++p)
+            for (const RawNode* node : t.raw_leaves)
+                for (node = node->parent; node; node = node->parent) sum += node->value;
+        return sum;
+    }
+};
+
+struct ArenaWalk {
+    static constexpr const char* name = "arena index";
+    static uint64_t walk(const Trees& t, std::size_t passes) {
+        uint64_t sum = 0;
+        const ArenaNode* arena = t.arena.data();
+        for (std::size_t p = 0; p < passes; ++p)
+            for (uint32_t i : t.arena_leaves)
+                for (i = arena[i].parent; i != NIL; i = arena[i].parent) sum += arena[i].value;
+        return sum;
+    }
+};
+
+// ns per hop as seen by one of `threads` concurrent walkers.
+template <typename Walk>
+static double measure(const Trees& t, std::size_t depth, std::size_t passes,
+                      unsigned threads, uint64_t& checksum) {
+    std::atomic<bool> go{false};
+    std::vector<uint64_t> sums(threads, 0);
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i)
+        pool.emplace_back([&, i] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            sums[i] = Walk::walk(t, passes);
+        });
+    Timer<> timer;
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    const double ms = timer.elapsed_ms();
+    checksum = sums[0];
+    const double hops = static_cast<double>(passes * t.arena_leaves.size() * depth);
+    return ms * 1e6 / hops;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t PASSES =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 10;
+    const unsigned MAX_THREADS =
+        argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                 : std::max(4u, std::thread::hardware_concurrency());
+
+    std::cout << "micrometrics - parent walk: weak_ptr::lock vs raw back-pointer vs arena index\n"
+              << "Leaves     : " << LEAVES << " per tree\n"
+              << "Passes     : " << PASSES << " walks of every leaf per thread\n"
+              << "Threads    : 1 to " << MAX_THREADS << "\n";
+
+    const int TW = 10;
+    const int CW = 16;
+    const int TOTAL = TW + CW * 3;
+
+    for (std::size_t depth : {16u, 64u, 256u, 1024u}) {
+        const Shape shape = make_shape(depth);
+        const Trees trees = build(shape);
+
+        std::cout << "\n---> depth=" << depth << "  nodes=" << shape.parent.size()
+                  << "  (ns per hop)\n";
+        std::cout << std::right << std::setw(TW) << "Threads"
+                  << std::setw(CW) << WeakWalk::name
+                  << std::setw(CW) << RawWalk::name
+                  << std::setw(CW) << ArenaWalk::name << "\n";
+        std::cout << std::string(TOTAL, '-') << "\n";
+
+        for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2) {
+            uint64_t cw = 0, cr = 0, ca = 0;
+            const double weak  = measure<WeakWalk>(trees, depth, PASSES, threads, cw);
+            const double raw   = measure<RawWalk>(trees, depth, PASSES, threads, cr);
+            const double arena = measure<ArenaWalk>(trees, depth, PASSES, threads, ca);
+            if (cw != cr || cr != ca) {
+                std::cerr << "ERROR [depth=" << depth << "]: walk sums differ ("
+                          << cw << ", " << cr << ", " << ca << ")\n";
+                return 1;
+            }
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::setw(TW) << threads
+                      << std::setw(CW) << weak
+                      << std::setw(CW) << raw
+                      << std::setw(CW) << arena << "\n";
+        }
+        std::cout << std::string(TOTAL, '-') << "\n";
+    }
+
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,1589 @@
+/* micrometrics : Symbol Registry Backends
+ *
+ * The 0001 registry hashes every incoming symbol into a std::unordered_map
+ * behind a mutex. For a small universe (0001 interns 45 symbols) hashing,
+ * the bucket walk and the std::string key build may cost more than simply
+ * comparing the query against every known key. Backends, all exposing
+ * get_id(std::string_view) (lookup, insert on miss) and get_symbol(id):
+ *
+ *   scan 8B       ScanRegistry<8>: keys packed into 8 zero-padded bytes
+ *                 (symbols up to 8 chars) in one contiguous 32-byte-aligned
+ *                 array; get_id compares the query against 4 keys per AVX2
+ *                 instruction (2 per SSE2 instruction)
+ *   scan 16B      ScanRegistry<16>: 16-byte keys (up to 16 chars), split
+ *                 into aligned low / high word arrays so one AVX2 compare
+ *                 pair checks 4 keys (2 with SSE2)
+ *   flat hash     open addressing over the same packed 16-byte keys,
+ *                 linear probing, load factor <= 1/2
+ *   unordered_map std::unordered_map<std::string, uint32_t>, no lock
+ *   0001 registry std::unordered_map + std::mutex, as in 0001
+ *
+ * Packed keys are zero padded, so symbols must not contain NUL bytes and
+ * may not exceed the key width (std::length_error otherwise). Unused slots
+ * at the end of a scan array hold all-ones keys, which no symbol packs to.
+ *
+ * Instruction set
+ *   Chosen at compile time: AVX2 when built with -mavx2 (or -march=native
+ *   on an AVX2 host), SSE2 on any other x86-64 target, a scalar loop
+ *   elsewhere. The active path is printed at start-up.
+ *
+ * Concurrent registry
+ *   AdaptiveRegistry keeps ids and names itself and looks symbols up in a
+ *   replaceable SymbolIndex (scan, flat hash or 16-way sharded flat hash,
+ *   all with lock-free find). It watches universe size, miss rate and
+ *   writer-lock contention and migrates between index kinds without
+ *   blocking lookups; see the class comment for the policy. Each static
+ *   mode is the same front end pinned to one index kind.
+ *
+ * Scenarios
+ *   [scan]     Universe sizes 8, 16, ... 1024 random tickers of 3 to 8
+ *              letters, all interned before timing; one thread runs get_id
+ *              over `lookups` std::string copies drawn uniformly from the
+ *              universe. Reported: ns per get_id, and per hash backend the
+ *              smallest universe where it beats the best scan.
+ *   [adaptive] Universe 8, 64, 512, 4096 x threads 1, 2, 4, ... N; every
+ *              cell starts from an empty registry and the threads share
+ *              `lookups` get_id calls. Workloads: steady (universe only)
+ *              and listings (25% never-seen symbols). Reported: M lookups/s
+ *              for each static mode, the 0001 registry and the adaptive
+ *              registry, plus the index the adaptive registry ended on.
+ *   [growth]   One thread grows an empty registry to `symbols` 19-char
+ *              option listings (default 10 000 000); every step lists one
+ *              new symbol and looks up a random listed one. Meanwhile
+ *              max_threads - 1 reader threads (at least 1) look up random
+ *              listed symbols, at most once per step each, and wait on the
+ *              mutex whenever the writer is rehashing. Backends: the
+ *              0001 registry, RehashRegistry with a full rehash on growth
+ *              and RehashRegistry rehashing incrementally (two tables, a
+ *              few old slots moved per call). Reported: p50, p99, p99.99
+ *              and max ns per writer insert, writer lookup and reader
+ *              lookup.
+ *   [storm]    4096 symbols listed before timing; one writer runs `lookups`
+ *              get_id of which a fraction are never-seen listings (0, 1, 10
+ *              and 50%, or 0 and `new_percent`), as on expiry-roll or IPO
+ *              days. Each cell runs on fresh registries: writer alone (best
+ *              of 3), then next to max_threads - 1 readers looping over
+ *              listed symbols. Reported: writer M get_id/s, amortized ns per insert
+ *              (writer time beyond the 0% row's cost for the hits), reader
+ *              M lookups/s with the writer running and its change vs 0%.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -mavx2 -pthread -o 0010-registry-backends 0010-registry-backends.cpp
+ *   (drop -mavx2 for the SSE2 path)
+ *
+ * Run:
+ *   ./0010-registry-backends [all|scan|adaptive|growth|storm] [lookups] [max_threads]
+ *                            [new_percent]
+ *   default: all, lookups=2 000 000 per cell (growth: symbols=lookups when
+ *            given, 10 000 000 otherwise), new_percent: sweep 1, 10, 50,
+ *            max_threads=std::thread::hardware_concurrency() (at least 4)
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MM_SCAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MM_SCAN_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+
+// ---------------------------------------------------------------------------
+// Packed keys
+// ---------------------------------------------------------------------------
+constexpr uint32_t NIL = UINT32_MAX;
+constexpr uint64_t UNUSED_WORD = ~0ull;
+
+struct Key16 {
+    uint64_t lo;
+    uint64_t hi;
+    bool operator==(const Key16& o) const { return lo == o.lo && hi == o.hi; }
+};
+
+// Zero-padded copy of `symbol` as a 16-byte key (hi is 0 for KeyBytes == 8).
+template <std::size_t KeyBytes>
+static Key16 pack_key(std::string_view symbol) {
+    static_assert(KeyBytes == 8 || KeyBytes == 16, "KeyBytes must be 8 or 16");
+    if (symbol.size() > KeyBytes) throw std::length_error("symbol wider than the packed key");
+    char bytes[16] = {};
+    std::memcpy(bytes, symbol.data(), symbol.size());
+    Key16 key;
+    std::memcpy(&key.lo, bytes, 8);
+    std::memcpy(&key.hi, bytes + 8, 8);
+    return key;
+}
+
+static inline unsigned first_set(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+static const char* scan_isa() {
+#if defined(MM_SCAN_AVX2)
+    return "AVX2 (4 keys per compare)";
+#elif defined(MM_SCAN_SSE2)
+    return "SSE2 (2 keys per compare)";
+#else
+    return "scalar";
+#endif
+}
+
+
+// ---------------------------------------------------------------------------
+// Aligned word array
+// ---------------------------------------------------------------------------
+/* Contiguous uint64_t array on a 32-byte boundary whose capacity is a
+ * multiple of 4 words (one AVX2 register); slots past size() hold
+ * UNUSED_WORD so a full-register compare never matches them. */
+class AlignedWords {
+private:
+    static constexpr std::size_t ALIGN = 32;
+    uint64_t*   data_     = nullptr;
+    std::size_t capacity_ = 0;
+
+public:
+    AlignedWords() = default;
+    AlignedWords(const AlignedWords&) = delete;
+    AlignedWords& operator=(const AlignedWords&) = delete;
+    ~AlignedWords() { ::operator delete(data_, std::align_val_t{ALIGN}); }
+
+    uint64_t*       data()           { return data_; }
+    const uint64_t* data()     const { return data_; }
+    std::size_t     capacity() const { return capacity_; }
+
+    void grow(std::size_t used, std::size_t capacity) {
+        auto* fresh = static_cast<uint64_t*>(
+            ::operator new(capacity * sizeof(uint64_t), std::align_val_t{ALIGN}));
+        std::copy(data_, data_ + used, fresh);
+        std::fill(fresh + used, fresh + capacity, UNUSED_WORD);
+        ::operator delete(data_, std::align_val_t{ALIGN});
+        data_     = fresh;
+        capacity_ = capacity;
+    }
+};
+
+
+/* Position of `key` among the first `count` keys, or NIL. The vector loops
+ * read whole registers up to the next multiple of 4 keys; a match past
+ * `count` (an unused slot) is reported as NIL. `hi` is not read when !Wide.
+ *
+ * Concurrent = true never reads past `count`: the vector loops stop at the
+ * last whole register below it and a scalar loop checks the rest, so a
+ * reader does not touch the slot a writer is filling. */
+template <bool Wide, bool Concurrent = false>
+static uint32_t scan_keys(const uint64_t* lo, const uint64_t* hi, std::size_t count,
+                          const Key16& key) {
+    const std::size_t end = Concurrent ? count & ~std::size_t{3} : (count + 3) & ~std::size_t{3};
+    std::size_t pos = SIZE_MAX;
+#if defined(MM_SCAN_AVX2)
+    const __m256i qlo = _mm256_set1_epi64x(static_cast<long long>(key.lo));
+    const __m256i qhi = _mm256_set1_epi64x(static_cast<long long>(key.hi));
+    for (std::size_t i = 0; i < end; i += 4) {
+        __m256i eq = _mm256_cmpeq_epi64(
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(lo + i)), qlo);
+        if constexpr (Wide)
+            eq = _mm256_and_si256(eq, _mm256_cmpeq_epi64(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(hi + i)), qhi));
+        const unsigned mask =
+            static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+        if (mask) { pos = i + first_set(mask); break; }
+    }
+#elif defined(MM_SCAN_SSE2)
+    // SSE2 has no 64-bit compare: a key matches when both of its 32-bit halves do.
+    const __m128i qlo = _mm_set1_epi64x(static_cast<long long>(key.lo));
+    const __m128i qhi = _mm_set1_epi64x(static_cast<long long>(key.hi));
+    for (std::size_t i = 0; i < end; i += 2) {
+        __m128i eq = _mm_cmpeq_epi32(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(lo + i)), qlo);
+        if constexpr (Wide)
+            eq = _mm_and_si128(eq, _mm_cmpeq_epi32(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(hi + i)), qhi));
+        const unsigned halves = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+        const unsigned mask = halves & (halves >> 1) & 0x5u;
+        if (mask) { pos = i + (first_set(mask) >> 1); break; }
+    }
+#else
+    for (std::size_t i = 0; i < end; ++i)
+        if (lo[i] == key.lo && (!Wide || hi[i] == key.hi)) { pos = i; break; }
+#endif
+    if constexpr (Concurrent) {
+        for (std::size_t i = end; pos == SIZE_MAX && i < count; ++i)
+            if (lo[i] == key.lo && (!Wide || hi[i] == key.hi)) pos = i;
+    }
+    (void)hi;
+    return pos < count ? static_cast<uint32_t>(pos) : NIL;
+}
+
+static inline std::size_t hash_key(const Key16& k) {
+    uint64_t h = (k.lo ^ (k.hi * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
+
+// ---------------------------------------------------------------------------
+// Backends
+// ---------------------------------------------------------------------------
+template <std::size_t KeyBytes>
+class ScanRegistry {
+private:
+    static constexpr bool WIDE = KeyBytes == 16;
+
+    AlignedWords             lo_;
+    AlignedWords             hi_;   // unused for 8-byte keys
+    std::size_t              size_ = 0;
+    std::vector<std::string> names_;
+
+    uint32_t find(const Key16& key) const {
+        return scan_keys<WIDE>(lo_.data(), hi_.data(), size_, key);
+    }
+
+public:
+    static constexpr const char* name = WIDE ? "scan 16B" : "scan 8B";
+
+    uint32_t get_id(std::string_view symbol) {
+        const Key16 key = pack_key<KeyBytes>(symbol);
+        const uint32_t found = find(key);
+        if (found != NIL) return found;
+
+        if (size_ == lo_.capacity()) {
+            const std::size_t capacity = std::max<std::size_t>(8, lo_.capacity() * 2);
+            lo_.grow(size_, capacity);
+            if constexpr (WIDE) hi_.grow(size_, capacity);
+        }
+        lo_.data()[size_] = key.lo;
+        if constexpr (WIDE) hi_.data()[size_] = key.hi;
+        names_.emplace_back(symbol);
+        return static_cast<uint32_t>(size_++);
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return names_.at(id); }
+    std::size_t size() const { return size_; }
+};
+
+/* Open addressing over packed 16-byte keys; power-of-two table, linear
+ * probing, grows at half full. */
+class FlatHashRegistry {
+private:
+    struct Slot {
+        Key16    key;
+        uint32_t id = NIL;
+    };
+
+    std::vector<Slot>        slots_ = std::vector<Slot>(16);
+    std::vector<std::string> names_;
+
+    void rehash() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        const std::size_t mask = slots_.size() - 1;
+        for (const Slot& s : old) {
+            if (s.id == NIL) continue;
+            std::size_t i = hash_key(s.key) & mask;
+            while (slots_[i].id != NIL) i = (i + 1) & mask;
+            slots_[i] = s;
+        }
+    }
+
+public:
+    static constexpr const char* name = "flat hash";
+
+    uint32_t get_id(std::string_view symbol) {
+        const Key16 key = pack_key<16>(symbol);
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = hash_key(key) & mask;
+        for (; slots_[i].id != NIL; i = (i + 1) & mask)
+            if (slots_[i].key == key) return slots_[i].id;
+
+        if ((names_.size() + 1) * 2 > slots_.size()) {
+            rehash();
+            mask = slots_.size() - 1;
+            for (i = hash_key(key) & mask; slots_[i].id != NIL; i = (i + 1) & mask) {}
+        }
+        const uint32_t id = static_cast<uint32_t>(names_.size());
+        slots_[i] = {key, id};
+        names_.emplace_back(symbol);
+        return id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return names_.at(id); }
+    std::size_t size() const { return names_.size(); }
+};
+
+class UnorderedRegistry {
+private:
+    std::unordered_map<std::string, uint32_t> string_to_id_;
+    std::vector<std::string>                  id_to_string_;
+
+public:
+    static constexpr const char* name = "unordered_map";
+
+    uint32_t get_id(std::string_view symbol) {
+        std::string key(symbol);
+        auto it = string_to_id_.find(key);
+        if (it != string_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
+        string_to_id_.emplace(std::move(key), new_id);
+        id_to_string_.emplace_back(symbol);
+        return new_id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return id_to_string_.at(id); }
+    std::size_t size() const { return id_to_string_.size(); }
+};
+
+// The 0001 SymbolRegistry: unordered_map behind a mutex.
+class LockedRegistry {
+private:
+    std::unordered_map<std::string, uint32_t> string_to_id_;
+    std::vector<std::string>                  id_to_string_;
+    std::mutex                                mtx;
+
+public:
+    static constexpr const char* name = "0001 registry";
+
+    uint32_t get_id(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string key(symbol);
+        auto it = string_to_id_.find(key);
+        if (it != string_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
+        string_to_id_[key] = new_id;
+        id_to_string_.emplace_back(symbol);
+        return new_id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return id_to_string_.at(id); }
+    std::size_t size() const { return id_to_string_.size(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Concurrent indexes
+// ---------------------------------------------------------------------------
+/* Fixed-capacity key -> id maps shared by many threads. find() never locks.
+ * A writer first reserves room for the key (false once the index is full),
+ * then insert()s a key it has checked to be absent, under the index's own
+ * writer lock; a failed try_lock on that lock counts as contended. Capacity
+ * never changes: AdaptiveRegistry grows an index by migrating to a bigger
+ * one. */
+enum class IndexKind { Scan, Flat, Sharded };
+
+static const char* kind_name(IndexKind kind) {
+    switch (kind) {
+        case IndexKind::Scan:    return "scan";
+        case IndexKind::Flat:    return "flat";
+        case IndexKind::Sharded: return "sharded";
+    }
+    return "?";
+}
+
+class SymbolIndex {
+protected:
+    std::atomic<uint64_t>    contended_{0};
+    std::atomic<std::size_t> reserved_{0};
+
+    bool reserve_below(std::size_t limit) {
+        if (reserved_.fetch_add(1, std::memory_order_relaxed) < limit) return true;
+        reserved_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    template <typename Mutex>
+    std::unique_lock<Mutex> lock_counted(Mutex& mtx) {
+        std::unique_lock<Mutex> lock(mtx, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            contended_.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+        return lock;
+    }
+
+public:
+    virtual ~SymbolIndex() = default;
+    virtual IndexKind   kind() const = 0;
+    virtual std::size_t capacity() const = 0;
+    virtual uint32_t    find(const Key16& key) const = 0;
+    virtual bool        try_reserve(const Key16& key) = 0;
+    virtual void        unreserve(const Key16& key) = 0;
+    virtual void        insert(const Key16& key, uint32_t id) = 0;
+    virtual uint64_t    contended() const { return contended_.load(std::memory_order_relaxed); }
+};
+
+/* Append-only scan array: keys and ids are written first, then `count_` is
+ * published with release, so a reader acquiring count_ sees complete
+ * entries below it. find() scans with scan_keys<.., true>, which reads
+ * only those entries, never the slot a writer is filling. */
+class ScanIndex final : public SymbolIndex {
+private:
+    AlignedWords                lo_;
+    AlignedWords                hi_;
+    std::unique_ptr<uint32_t[]> ids_;
+    std::atomic<std::size_t>    count_{0};
+    std::mutex                  write_;
+
+public:
+    explicit ScanIndex(std::size_t capacity) {
+        capacity = (capacity + 3) & ~std::size_t{3};
+        ids_.reset(new uint32_t[capacity]);
+        lo_.grow(0, capacity);
+        hi_.grow(0, capacity);
+    }
+
+    IndexKind   kind()     const override { return IndexKind::Scan; }
+    std::size_t capacity() const override { return lo_.capacity(); }
+
+    uint32_t find(const Key16& key) const override {
+        const std::size_t n = count_.load(std::memory_order_acquire);
+        const uint32_t pos = scan_keys<true, true>(lo_.data(), hi_.data(), n, key);
+        return pos == NIL ? NIL : ids_[pos];
+    }
+
+    bool try_reserve(const Key16&) override { return reserve_below(lo_.capacity()); }
+    void unreserve(const Key16&) override { reserved_.fetch_sub(1, std::memory_order_relaxed); }
+
+    void insert(const Key16& key, uint32_t id) override {
+        auto lock = lock_counted(write_);
+        const std::size_t n = count_.load(std::memory_order_relaxed);
+        lo_.data()[n] = key.lo;
+        hi_.data()[n] = key.hi;
+        ids_[n] = id;
+        count_.store(n + 1, std::memory_order_release);
+    }
+};
+
+/* Open addressing with linear probing. A slot's key is written before its
+ * id is stored with release, and readers compare the key only after
+ * acquiring a non-NIL id. Full at 3/4 load. */
+class FlatIndex final : public SymbolIndex {
+private:
+    std::unique_ptr<Key16[]>                 keys_;
+    std::unique_ptr<std::atomic<uint32_t>[]> ids_;
+    std::size_t                              mask_;
+    std::mutex                               write_;
+
+public:
+    explicit FlatIndex(std::size_t capacity) {
+        std::size_t slots = 16;
+        while (slots < capacity) slots *= 2;
+        keys_.reset(new Key16[slots]);
+        ids_.reset(new std::atomic<uint32_t>[slots]);
+        for (std::size_t i = 0; i < slots; ++i) ids_[i].store(NIL, std::memory_order_relaxed);
+        mask_ = slots - 1;
+    }
+
+    IndexKind   kind()     const override { return IndexKind::Flat; }
+    std::size_t capacity() const override { return mask_ + 1; }
+
+    uint32_t find(const Key16& key) const override {
+        for (std::size_t i = hash_key(key) & mask_;; i = (i + 1) & mask_) {
+            const uint32_t id = ids_[i].load(std::memory_order_acquire);
+            if (id == NIL) return NIL;
+            if (keys_[i] == key) return id;
+        }
+    }
+
+    bool try_reserve(const Key16&) override { return reserve_below((mask_ + 1) / 4 * 3); }
+    void unreserve(const Key16&) override { reserved_.fetch_sub(1, std::memory_order_relaxed); }
+
+    void insert(const Key16& key, uint32_t id) override {
+        auto lock = lock_counted(write_);
+        std::size_t i = hash_key(key) & mask_;
+        while (ids_[i].load(std::memory_order_relaxed) != NIL) i = (i + 1) & mask_;
+        keys_[i] = key;
+        ids_[i].store(id, std::memory_order_release);
+    }
+};
+
+// SHARDS independent flat tables, each with its own writer lock.
+class ShardedIndex final : public SymbolIndex {
+private:
+    static constexpr std::size_t SHARDS = 16;
+    std::unique_ptr<FlatIndex> shards_[SHARDS];
+
+    FlatIndex& shard(const Key16& key) const {
+        return *shards_[((key.lo ^ key.hi) * 0x9E3779B97F4A7C15ull) >> 60];
+    }
+
+public:
+    explicit ShardedIndex(std::size_t capacity) {
+        for (auto& s : shards_) s = std::make_unique<FlatIndex>(capacity / SHARDS);
+    }
+
+    IndexKind   kind()     const override { return IndexKind::Sharded; }
+    std::size_t capacity() const override { return shards_[0]->capacity() * SHARDS; }
+
+    uint32_t find(const Key16& key) const override { return shard(key).find(key); }
+
+    bool try_reserve(const Key16& key) override { return shard(key).try_reserve(key); }
+    void unreserve(const Key16& key) override { shard(key).unreserve(key); }
+    void insert(const Key16& key, uint32_t id) override { shard(key).insert(key, id); }
+
+    uint64_t contended() const override {
+        uint64_t total = 0;
+        for (const auto& s : shards_) total += s->contended();
+        return total;
+    }
+};
+
+static std::unique_ptr<SymbolIndex> make_index(IndexKind kind, std::size_t capacity) {
+    switch (kind) {
+        case IndexKind::Scan:    return std::make_unique<ScanIndex>(capacity);
+        case IndexKind::Flat:    return std::make_unique<FlatIndex>(capacity);
+        case IndexKind::Sharded: return std::make_unique<ShardedIndex>(capacity);
+    }
+    return nullptr;
+}
+
+
+// ---------------------------------------------------------------------------
+// Adaptive registry
+// ---------------------------------------------------------------------------
+/* Front end over a replaceable SymbolIndex.
+ *
+ * Ids and names live in the registry (chunked, never moved). Lookups load
+ * the active index and call find() with no lock. A miss takes one of
+ * STRIPES insert locks (by key hash), re-checks the active index and any
+ * index being migrated to, then allocates the next id and inserts it into
+ * both. The stripe locks make get_id's check-then-insert atomic per key,
+ * so every symbol gets exactly one id.
+ *
+ * Migration, run by the thread that trips the policy, never blocks lookups:
+ *   1. under all stripes: publish `next_`, snapshot the id count
+ *   2. copy ids [0, snapshot) into next_; concurrent inserts go to both
+ *   3. under all stripes: active_ = next_, or, when concurrent inserts
+ *      left next_ no room for the snapshot, drop next_ and restart at
+ *      twice the capacity
+ * Inserts wait only for steps 1 and 3. A replaced index is kept until the
+ * registry is destroyed, since lookups may still be reading it.
+ *
+ * Policy (Mode::Adaptive), evaluated on misses and every 2^20 lookups:
+ *   - scan while the universe is at most SCAN_MAX, then flat
+ *   - grow x4 (same kind) past half capacity
+ *   - flat -> sharded when more than 1/8 of the last 1024 inserts found
+ *     the index writer lock taken
+ *   - sharded -> flat after 2^20 lookups with fewer than 1 miss in 10 000
+ *     and no contended insert
+ * The static modes keep their kind and only grow. */
+class AdaptiveRegistry {
+public:
+    enum class Mode { Adaptive, Scan, Flat, Sharded };
+
+private:
+    static constexpr std::size_t STRIPES     = 64;
+    static constexpr std::size_t SCAN_MAX    = 32;   // scan beats flat hash below ~16-64 (TEST scan)
+    static constexpr std::size_t CHUNK       = 4096;
+    static constexpr std::size_t MAX_CHUNKS  = 4096;
+    static constexpr uint64_t    LOOKUP_WINDOW = 1u << 20;
+    static constexpr uint64_t    MISS_WINDOW   = 1024;
+
+    struct Entry {
+        Key16       key;
+        std::string name;
+    };
+    struct alignas(64) Stripe {
+        std::mutex mtx;
+    };
+
+    const Mode                                mode_;
+    std::atomic<SymbolIndex*>                 active_;
+    std::atomic<SymbolIndex*>                 next_{nullptr};
+    std::vector<std::unique_ptr<SymbolIndex>> indexes_;   // every index ever built
+    Stripe                                    stripes_[STRIPES];
+
+    std::unique_ptr<std::atomic<Entry*>[]>    chunks_;
+    std::mutex                                chunk_mtx_;
+    std::atomic<uint32_t>                     size_{0};
+
+    alignas(64) std::atomic<uint64_t> lookups_{0};
+    std::atomic<uint64_t>             misses_{0};
+    std::atomic<uint64_t>             migrations_{0};
+
+    // Policy state, guarded by policy_mtx_.
+    std::mutex policy_mtx_;
+    uint64_t   window_lookups_   = 0;
+    uint64_t   window_misses_    = 0;
+    uint64_t   window_contended_ = 0;
+
+    Entry& entry(uint32_t id) const {
+        return chunks_[id / CHUNK].load(std::memory_order_acquire)[id % CHUNK];
+    }
+
+    uint32_t allocate(const Key16& key, std::string_view symbol) {
+        const uint32_t id = size_.fetch_add(1, std::memory_order_relaxed);
+        if (id / CHUNK >= MAX_CHUNKS) throw std::length_error("AdaptiveRegistry: id space exhausted");
+        if (id % CHUNK == 0) {
+            std::lock_guard<std::mutex> lock(chunk_mtx_);
+            if (!chunks_[id / CHUNK].load(std::memory_order_relaxed))
+                chunks_[id / CHUNK].store(new Entry[CHUNK], std::memory_order_release);
+        } else {
+            while (!chunks_[id / CHUNK].load(std::memory_order_acquire)) std::this_thread::yield();
+        }
+        Entry& e = entry(id);
+        e.key  = key;
+        e.name = std::string(symbol);
+        return id;
+    }
+
+    void lock_all()   { for (auto& s : stripes_) s.mtx.lock(); }
+    void unlock_all() { for (auto& s : stripes_) s.mtx.unlock(); }
+
+    /* Caller holds policy_mtx_. Inserts running during the copy also fill
+     * `next`; if they leave no room for the snapshot, the target is
+     * abandoned (kept in indexes_, like every replaced index) and the
+     * migration restarts at twice the capacity. */
+    void migrate(IndexKind kind, std::size_t capacity) {
+        for (;; capacity *= 2) {
+            auto fresh = make_index(kind, capacity);
+            SymbolIndex* next = fresh.get();
+            indexes_.push_back(std::move(fresh));
+
+            lock_all();
+            next_.store(next, std::memory_order_release);
+            const uint32_t snapshot = size_.load(std::memory_order_relaxed);
+            unlock_all();
+
+            bool fits = true;
+            for (uint32_t id = 0; id < snapshot && fits; ++id) {
+                const Key16& key = entry(id).key;
+                fits = next->try_reserve(key);
+                if (fits) next->insert(key, id);
+            }
+
+            lock_all();
+            if (fits) active_.store(next, std::memory_order_release);
+            next_.store(nullptr, std::memory_order_relaxed);
+            unlock_all();
+            if (fits) break;
+        }
+
+        migrations_.fetch_add(1, std::memory_order_relaxed);
+        window_lookups_   = lookups_.load(std::memory_order_relaxed);
+        window_misses_    = misses_.load(std::memory_order_relaxed);
+        window_contended_ = 0;
+    }
+
+    // Caller holds policy_mtx_ and no stripe. `full`: an index that rejected a reservation.
+    void apply_policy(const SymbolIndex* full) {
+        const SymbolIndex* index = active_.load(std::memory_order_acquire);
+        const IndexKind    kind  = index->kind();
+        const std::size_t  size  = size_.load(std::memory_order_relaxed);
+        const std::size_t  cap   = index->capacity();
+        const uint64_t lookups   = lookups_.load(std::memory_order_relaxed);
+        const uint64_t misses    = misses_.load(std::memory_order_relaxed);
+        const uint64_t contended = index->contended();
+        const bool     crowded   = full == index || size * 2 > cap;
+
+        if (mode_ != Mode::Adaptive) {
+            if (crowded) migrate(kind, cap * 4);
+            return;
+        }
+        if (kind == IndexKind::Scan && size > SCAN_MAX) {
+            migrate(IndexKind::Flat, size * 4);
+        } else if (crowded) {
+            migrate(kind, cap * 4);
+        } else if (kind != IndexKind::Sharded && misses - window_misses_ >= MISS_WINDOW) {
+            if ((contended - window_contended_) * 8 > misses - window_misses_)
+                migrate(IndexKind::Sharded, std::max(cap, size * 4));
+            else {
+                window_misses_    = misses;
+                window_contended_ = contended;
+            }
+        } else if (kind == IndexKind::Sharded && lookups - window_lookups_ >= LOOKUP_WINDOW) {
+            if ((misses - window_misses_) * 10'000 < lookups - window_lookups_
+                    && contended == window_contended_)
+                migrate(IndexKind::Flat, cap);
+            else {
+                window_lookups_   = lookups;
+                window_misses_    = misses;
+                window_contended_ = contended;
+            }
+        }
+    }
+
+    void count_lookup() {
+        struct Tally {
+            const AdaptiveRegistry* owner = nullptr;
+            uint32_t                n     = 0;
+        };
+        thread_local Tally tally;
+        if (tally.owner != this) tally = {this, 0};
+        if (++tally.n < 1024) return;
+        tally.n = 0;
+        lookups_.fetch_add(1024, std::memory_order_relaxed);
+        if (mode_ == Mode::Adaptive && policy_mtx_.try_lock()) {
+            apply_policy(nullptr);
+            policy_mtx_.unlock();
+        }
+    }
+
+    uint32_t insert_slow(const Key16& key, std::string_view symbol) {
+        for (;;) {
+            const SymbolIndex* full = nullptr;
+            uint32_t id = NIL;
+            {
+                std::lock_guard<std::mutex> lock(stripes_[hash_key(key) % STRIPES].mtx);
+                SymbolIndex* active = active_.load(std::memory_order_acquire);
+                SymbolIndex* next   = next_.load(std::memory_order_acquire);
+                id = active->find(key);
+                if (id == NIL && next) id = next->find(key);
+                if (id != NIL) return id;
+
+                if (!active->try_reserve(key)) {
+                    full = active;
+                } else if (next && !next->try_reserve(key)) {
+                    active->unreserve(key);
+                    full = next;
+                } else {
+                    id = allocate(key, symbol);
+                    active->insert(key, id);
+                    if (next) next->insert(key, id);
+                    misses_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (id != NIL) {
+                if (policy_mtx_.try_lock()) {
+                    apply_policy(nullptr);
+                    policy_mtx_.unlock();
+                }
+                return id;
+            }
+            // No room: grow the full index, or wait for the thread already migrating.
+            std::lock_guard<std::mutex> policy(policy_mtx_);
+            apply_policy(full);
+        }
+    }
+
+public:
+    explicit AdaptiveRegistry(Mode mode = Mode::Adaptive)
+        : mode_(mode), chunks_(new std::atomic<Entry*>[MAX_CHUNKS]) {
+        for (std::size_t i = 0; i < MAX_CHUNKS; ++i) chunks_[i].store(nullptr, std::memory_order_relaxed);
+        const IndexKind kind = mode == Mode::Flat    ? IndexKind::Flat
+                             : mode == Mode::Sharded ? IndexKind::Sharded
+                                                     : IndexKind::Scan;
+        indexes_.push_back(make_index(kind, kind == IndexKind::Sharded ? 256 : 64));
+        active_.store(indexes_.back().get(), std::memory_order_release);
+    }
+
+    ~AdaptiveRegistry() {
+        for (std::size_t i = 0; i < MAX_CHUNKS; ++i) delete[] chunks_[i].load(std::memory_order_relaxed);
+    }
+
+    static const char* mode_name(Mode mode) {
+        switch (mode) {
+            case Mode::Adaptive: return "adaptive";
+            case Mode::Scan:     return "scan";
+            case Mode::Flat:     return "flat hash";
+            case Mode::Sharded:  return "sharded hash";
+        }
+        return "?";
+    }
+
+    uint32_t get_id(std::string_view symbol) {
+        const Key16 key = pack_key<16>(symbol);
+        count_lookup();
+        const uint32_t id = active_.load(std::memory_order_acquire)->find(key);
+        return id != NIL ? id : insert_slow(key, symbol);
+    }
+
+    // Valid for any id returned by get_id.
+    std::string_view get_symbol(uint32_t id) const { return entry(id).name; }
+
+    std::size_t size()       const { return size_.load(std::memory_order_acquire); }
+    IndexKind   kind()       const { return active_.load(std::memory_order_acquire)->kind(); }
+    uint64_t    migrations() const { return migrations_.load(std::memory_order_relaxed); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Growth: full vs incremental rehash
+// ---------------------------------------------------------------------------
+// Append-only names in fixed chunks: growing never moves existing strings.
+class ChunkedNames {
+private:
+    static constexpr std::size_t CHUNK = 4096;
+    std::vector<std::unique_ptr<std::string[]>> chunks_;
+    std::size_t                                 size_ = 0;
+
+public:
+    void push_back(std::string_view name) {
+        if (size_ % CHUNK == 0) chunks_.emplace_back(new std::string[CHUNK]);
+        chunks_.back()[size_ % CHUNK] = std::string(name);
+        ++size_;
+    }
+    const std::string& operator[](std::size_t i) const { return chunks_[i / CHUNK][i % CHUNK]; }
+    std::size_t size() const { return size_; }
+};
+
+/* Registry over an open-addressing table of (hash, id) slots with linear
+ * probing, names in ChunkedNames, a mutex like the 0001 registry. Grows to
+ * twice the slots past half load.
+ *
+ *   Incremental = false  the inserting get_id moves every entry at once
+ *   Incremental = true   the full table is kept as old_; every get_id (hit
+ *                        or miss) first moves the next MIGRATE_STEP old
+ *                        slots into table_. Lookups probe table_, then
+ *                        old_. The next growth needs C/2 inserts for an old
+ *                        table of C slots, so two slots per get_id drain it
+ *                        in time (any remainder is drained by grow()).
+ *
+ * old_ is drained from the top down: every slot at or past `cursor_` counts
+ * as moved, so an old_ probe that reaches the cursor wraps to slot 0, and
+ * every SHRINK_STEP slots the array is shrunk with realloc, returning its
+ * memory a slice at a time rather than in one large free at the end.
+ *
+ * Slot arrays come from calloc (id 0 = empty), which large allocations get
+ * as untouched zero pages: a new table costs page faults spread over the
+ * following inserts rather than one up-front clear. */
+template <bool Incremental>
+class RehashRegistry {
+private:
+    static constexpr uint32_t    EMPTY        = 0;
+    static constexpr std::size_t MIGRATE_STEP = 2;
+    static constexpr std::size_t SHRINK_STEP  = 65'536;   // slots, 1 MiB
+
+    struct Slot {
+        uint64_t hash;
+        uint32_t id;   // EMPTY or id + 1
+    };
+
+    struct Table {
+        Slot*       slots = nullptr;
+        std::size_t mask  = 0;
+
+        Table() = default;
+        explicit Table(std::size_t capacity)
+            : slots(static_cast<Slot*>(std::calloc(capacity, sizeof(Slot)))), mask(capacity - 1) {
+            if (!slots) throw std::bad_alloc();
+        }
+        Table(Table&& o) noexcept : slots(o.slots), mask(o.mask) { o.slots = nullptr; o.mask = 0; }
+        Table& operator=(Table&& o) noexcept {
+            std::swap(slots, o.slots);
+            std::swap(mask, o.mask);
+            return *this;
+        }
+        ~Table() { std::free(slots); }
+
+        std::size_t capacity() const { return slots ? mask + 1 : 0; }
+
+        void place(uint64_t hash, uint32_t id) {
+            std::size_t i = hash & mask;
+            while (slots[i].id != EMPTY) i = (i + 1) & mask;
+            slots[i] = {hash, id};
+        }
+    };
+
+    Table        table_{16};
+    Table        old_;
+    std::size_t  cursor_ = 0;   // old_ slots [cursor_, capacity) are moved
+    ChunkedNames names_;
+    std::mutex   mtx;
+    std::size_t  growths_ = 0;
+
+    uint32_t find_in(const Slot* slots, std::size_t mask, std::size_t end,
+                     uint64_t hash, std::string_view symbol) const {
+        std::size_t i = hash & mask;
+        for (std::size_t probes = 0; probes < end; ++probes, i = (i + 1) & mask) {
+            if (i >= end) i = 0;
+            const Slot& s = slots[i];
+            if (s.id == EMPTY) return NIL;
+            if (s.hash == hash && names_[s.id - 1] == symbol) return s.id - 1;
+        }
+        return NIL;
+    }
+
+    void migrate(std::size_t steps) {
+        const std::size_t stop = cursor_ > steps ? cursor_ - steps : 0;
+        while (cursor_ > stop) {
+            const Slot& s = old_.slots[--cursor_];
+            if (s.id != EMPTY) table_.place(s.hash, s.id);
+        }
+        if (cursor_ == 0) {
+            old_ = Table();
+        } else if (cursor_ % SHRINK_STEP == 0) {
+            // Shrinking keeps the block in place (glibc: mremap for large blocks).
+            if (void* p = std::realloc(old_.slots, cursor_ * sizeof(Slot)))
+                old_.slots = static_cast<Slot*>(p);
+        }
+    }
+
+    void grow() {
+        ++growths_;
+        if constexpr (Incremental) {
+            if (old_.slots) migrate(old_.capacity());
+            Table fresh(table_.capacity() * 2);
+            old_   = std::move(table_);
+            table_ = std::move(fresh);
+            cursor_ = old_.capacity();
+        } else {
+            Table fresh(table_.capacity() * 2);
+            for (std::size_t i = 0; i < table_.capacity(); ++i)
+                if (table_.slots[i].id != EMPTY) fresh.place(table_.slots[i].hash, table_.slots[i].id);
+            table_ = std::move(fresh);
+        }
+    }
+
+public:
+    static constexpr const char* name = Incremental ? "incremental" : "full rehash";
+
+    uint32_t get_id(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        const uint64_t hash = std::hash<std::string_view>{}(symbol);
+        if constexpr (Incremental) {
+            if (old_.slots) migrate(MIGRATE_STEP);
+        }
+        uint32_t id = find_in(table_.slots, table_.mask, table_.capacity(), hash, symbol);
+        if (id == NIL && Incremental && old_.slots)
+            id = find_in(old_.slots, old_.mask, cursor_, hash, symbol);
+        if (id != NIL) return id;
+
+        if ((names_.size() + 1) * 2 > table_.capacity()) grow();
+        id = static_cast<uint32_t>(names_.size());
+        names_.push_back(symbol);
+        table_.place(hash, id + 1);
+        return id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return names_[id]; }
+    std::size_t size()    const { return names_.size(); }
+    std::size_t growths() const { return growths_; }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+// `n` distinct tickers of 3 to 8 upper-case letters.
+static std::vector<std::string> generate_universe(std::size_t n, unsigned seed = 7) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> length(3, 8);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> universe;
+    while (universe.size() < n) {
+        std::string s(static_cast<std::size_t>(length(rng)), ' ');
+        for (char& c : s) c = static_cast<char>(letter(rng));
+        if (seen.insert(s).second) universe.push_back(std::move(s));
+    }
+    return universe;
+}
+
+static std::vector<std::string>
+generate_stream(const std::vector<std::string>& universe, std::size_t n, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, universe.size() - 1);
+    std::vector<std::string> stream;
+    stream.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) stream.push_back(universe[pick(rng)]);
+    return stream;
+}
+
+/* Interns the universe, then times get_id over the stream. Returns ns per
+ * lookup; `checksum` is the sum of the ids seen, or 0 if an id does not map
+ * back to its symbol. */
+template <typename Registry>
+static double measure(const std::vector<std::string>& universe,
+                      const std::vector<std::string>& stream, uint64_t& checksum) {
+    Registry registry;
+    for (const auto& s : universe) registry.get_id(s);
+
+    uint64_t warm = 0;
+    for (const auto& s : stream) warm += registry.get_id(s);
+
+    Timer<> t;
+    uint64_t sum = 0;
+    for (const auto& s : stream) sum += registry.get_id(s);
+    const double ms = t.elapsed_ms();
+
+    checksum = sum == warm && registry.size() == universe.size() ? sum : 0;
+    for (uint32_t id = 0; id < universe.size(); ++id)
+        if (registry.get_symbol(id) != universe[id]) checksum = 0;
+    return ms * 1e6 / static_cast<double>(stream.size());
+}
+
+
+/* Fresh listings: `n` symbols no universe contains. */
+static std::string fresh_symbol(unsigned thread, std::size_t i) {
+    return "N" + std::to_string(thread) + "_" + std::to_string(i);
+}
+
+/* One stream per thread: `per_thread` symbols, each a fresh listing with
+ * probability `fresh`, otherwise drawn from the universe. */
+static std::vector<std::vector<std::string>>
+generate_thread_streams(const std::vector<std::string>& universe, unsigned threads,
+                        std::size_t per_thread, double fresh) {
+    std::vector<std::vector<std::string>> streams(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        std::mt19937 rng(100 + t);
+        std::uniform_int_distribution<std::size_t> pick(0, universe.size() - 1);
+        std::bernoulli_distribution is_fresh(fresh);
+        streams[t].reserve(per_thread);
+        for (std::size_t i = 0; i < per_thread; ++i)
+            streams[t].push_back(is_fresh(rng) ? fresh_symbol(t, i) : universe[pick(rng)]);
+    }
+    return streams;
+}
+
+/* All threads start on an empty registry at once and run get_id over their
+ * own stream. Returns M lookups per second, or -1 when the registry did not
+ * give every distinct symbol exactly one id. */
+template <typename Registry>
+static double run_threads(Registry& registry, const std::vector<std::vector<std::string>>& streams,
+                          std::size_t distinct) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    std::vector<uint64_t> sums(streams.size(), 0);
+    for (std::size_t t = 0; t < streams.size(); ++t)
+        pool.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            uint64_t sum = 0;
+            for (const auto& s : streams[t]) sum += registry.get_id(s);
+            sums[t] = sum;
+        });
+    Timer<> timer;
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    const double ms = timer.elapsed_ms();
+
+    if (registry.size() != distinct) return -1.0;
+    for (const auto& stream : streams)
+        for (std::size_t i = 0; i < stream.size() && i < 4096; ++i)
+            if (registry.get_symbol(registry.get_id(stream[i])) != stream[i]) return -1.0;
+
+    std::size_t total = 0;
+    for (const auto& stream : streams) total += stream.size();
+    return static_cast<double>(total) / (ms * 1e3);
+}
+
+
+static int run_scan_scenario(std::size_t lookups) {
+    std::cout << "\n---> [scan] get_id on a fully interned universe, 1 thread (ns per lookup)\n"
+              << "Scan path  : " << scan_isa() << "\n";
+
+    const int UW = 10;
+    const int CW = 15;
+    const int TOTAL = UW + CW * 5;
+    const char* names[5] = {ScanRegistry<8>::name, ScanRegistry<16>::name,
+                            FlatHashRegistry::name, UnorderedRegistry::name,
+                            LockedRegistry::name};
+
+    std::cout << std::right << std::setw(UW) << "Universe";
+    for (const char* n : names) std::cout << std::setw(CW) << n;
+    std::cout << "\n" << std::string(TOTAL, '-') << "\n";
+
+    std::vector<std::size_t> sizes;
+    std::vector<std::vector<double>> rows;
+    for (std::size_t n = 8; n <= 1024; n *= 2) {
+        const auto universe = generate_universe(n);
+        const auto stream = generate_stream(universe, lookups);
+
+        uint64_t c[5];
+        std::vector<double> ns = {
+            measure<ScanRegistry<8>>(universe, stream, c[0]),
+            measure<ScanRegistry<16>>(universe, stream, c[1]),
+            measure<FlatHashRegistry>(universe, stream, c[2]),
+            measure<UnorderedRegistry>(universe, stream, c[3]),
+            measure<LockedRegistry>(universe, stream, c[4]),
+        };
+        for (uint64_t x : c) {
+            if (x == 0 || x != c[0]) {
+                std::cerr << "ERROR [scan universe=" << n << "]: backends disagree on ids\n";
+                return 1;
+            }
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::setw(UW) << n;
+        for (double v : ns) std::cout << std::setw(CW) << v;
+        std::cout << "\n";
+        sizes.push_back(n);
+        rows.push_back(std::move(ns));
+    }
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    std::cout << "\n---> [scan] crossover: smallest universe where the backend beats the best scan\n";
+    for (std::size_t b = 2; b < 5; ++b) {
+        std::string at = "none up to 1024";
+        for (std::size_t r = 0; r < rows.size(); ++r) {
+            if (rows[r][b] < std::min(rows[r][0], rows[r][1])) {
+                at = std::to_string(sizes[r]);
+                break;
+            }
+        }
+        std::cout << "  " << std::left << std::setw(CW) << names[b] << at << "\n";
+    }
+    std::cout << std::right;
+    return 0;
+}
+
+static int run_adaptive_scenario(std::size_t lookups, unsigned max_threads) {
+    using Mode = AdaptiveRegistry::Mode;
+    const Mode modes[4] = {Mode::Scan, Mode::Flat, Mode::Sharded, Mode::Adaptive};
+
+    const int UW = 10;
+    const int TW = 9;
+    const int CW = 14;
+    const int TOTAL = UW + TW + CW * 5 + 24;
+
+    struct Workload {
+        const char* name;
+        double      fresh;
+    };
+    for (const Workload& w : {Workload{"steady", 0.0}, Workload{"listings", 0.25}}) {
+        std::cout << "\n---> [adaptive] " << w.name << ": " << w.fresh * 100
+                  << "% fresh listings, registry starts empty (M lookups/s, all threads)\n";
+        std::cout << std::right << std::setw(UW) << "Universe" << std::setw(TW) << "Threads";
+        for (Mode m : modes) std::cout << std::setw(CW) << AdaptiveRegistry::mode_name(m);
+        std::cout << std::setw(CW) << LockedRegistry::name
+                  << std::setw(24) << "adaptive ends as" << "\n";
+        std::cout << std::string(TOTAL, '-') << "\n";
+
+        for (std::size_t n : {8u, 64u, 512u, 4096u}) {
+            const auto universe = generate_universe(n);
+            for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+                const auto streams =
+                    generate_thread_streams(universe, threads, lookups / threads, w.fresh);
+                std::unordered_set<std::string_view> distinct;
+                for (const auto& stream : streams) distinct.insert(stream.begin(), stream.end());
+
+                std::cout << std::fixed << std::setprecision(2)
+                          << std::setw(UW) << n << std::setw(TW) << threads;
+                std::string ends_as;
+                for (Mode m : modes) {
+                    if (m == Mode::Scan && w.fresh > 0) {
+                        std::cout << std::setw(CW) << "-";   // unbounded universe
+                        continue;
+                    }
+                    AdaptiveRegistry registry(m);
+                    const double rate = run_threads(registry, streams, distinct.size());
+                    if (rate < 0) {
+                        std::cerr << "\nERROR [" << w.name << " universe=" << n << " threads="
+                                  << threads << "]: " << AdaptiveRegistry::mode_name(m)
+                                  << " assigned inconsistent ids\n";
+                        return 1;
+                    }
+                    std::cout << std::setw(CW) << rate;
+                    if (m == Mode::Adaptive)
+                        ends_as = std::string(kind_name(registry.kind())) + " ("
+                                + std::to_string(registry.migrations()) + " migr.)";
+                }
+                LockedRegistry locked;
+                const double rate = run_threads(locked, streams, distinct.size());
+                if (rate < 0) {
+                    std::cerr << "\nERROR [" << w.name << "]: 0001 registry assigned inconsistent ids\n";
+                    return 1;
+                }
+                std::cout << std::setw(CW) << rate << std::setw(24) << ends_as << "\n";
+            }
+        }
+        std::cout << std::string(TOTAL, '-') << "\n";
+    }
+    return 0;
+}
+
+/* OCC-style option symbol number i: 4-letter root, expiry, C/P and an
+ * 8-digit strike, 19 chars (past the SSO buffer, like real listings). */
+static std::string_view option_symbol(std::size_t i, char (&buf)[32]) {
+    const std::size_t root   = i / 20'000;
+    const std::size_t expiry = (i / 2'000) % 10;
+    const std::size_t strike = (i / 2) % 1'000;
+    char r[5] = {static_cast<char>('A' + root / 17'576 % 26), static_cast<char>('A' + root / 676 % 26),
+                 static_cast<char>('A' + root / 26 % 26),     static_cast<char>('A' + root % 26), 0};
+    const int n = std::snprintf(buf, sizeof(buf), "%s26%02zu18%c%08zu", r, expiry + 1,
+                                i % 2 ? 'P' : 'C', (strike + 1) * 500);
+    return {buf, static_cast<std::size_t>(n)};
+}
+
+struct LatencySummary {
+    double p50, p99, p9999, max;
+};
+
+static LatencySummary summarize(std::vector<uint64_t>& ns) {
+    auto at = [&](double q) {
+        const std::size_t k = std::min(ns.size() - 1, static_cast<std::size_t>(q * ns.size()));
+        std::nth_element(ns.begin(), ns.begin() + static_cast<std::ptrdiff_t>(k), ns.end());
+        return static_cast<double>(ns[k]);
+    };
+    return {at(0.50), at(0.99), at(0.9999), static_cast<double>(*std::max_element(ns.begin(), ns.end()))};
+}
+
+/* Grows an empty registry to `symbols` listings. Each step lists one new
+ * symbol, then looks up a random already-listed one; both calls are timed.
+ * Meanwhile `readers` threads time get_id on random listed symbols, at most
+ * one call per writer step each, so a reader blocked behind a rehash shows
+ * up as one long sample. Returns false when an id does not map back to its
+ * symbol. */
+template <typename Registry>
+static bool grow_and_time(std::size_t symbols, unsigned readers, std::vector<uint64_t>& insert_ns,
+                          std::vector<uint64_t>& lookup_ns, std::vector<uint64_t>& reader_ns,
+                          double& total_s) {
+    using Clock = std::chrono::steady_clock;
+    auto ns_between = [](Clock::time_point a, Clock::time_point b) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+    };
+
+    insert_ns.assign(symbols, 0);
+    lookup_ns.assign(symbols, 0);
+    std::mt19937_64 rng(42);
+    char buf[32];
+    bool ok = true;
+
+    auto registry = std::make_unique<Registry>();
+    std::atomic<std::size_t> listed{0};
+    std::atomic<bool>        done{false};
+    std::vector<std::vector<uint64_t>> samples(readers);
+    std::vector<char> good(readers, 1);
+    std::vector<std::thread> pool;
+    for (unsigned r = 0; r < readers; ++r)
+        pool.emplace_back([&, r] {
+            std::mt19937_64 reader_rng(1000 + r);
+            char reader_buf[32];
+            std::size_t seen = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const std::size_t n = listed.load(std::memory_order_acquire);
+                if (n == seen) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                seen = n;
+                const std::size_t j = reader_rng() % n;
+                std::string_view symbol = option_symbol(j, reader_buf);
+                const Clock::time_point t0 = Clock::now();
+                const uint32_t id = registry->get_id(symbol);
+                const Clock::time_point t1 = Clock::now();
+                samples[r].push_back(ns_between(t0, t1));
+                good[r] &= id == j;
+            }
+        });
+
+    Timer<> total;
+    for (std::size_t i = 0; i < symbols; ++i) {
+        std::string_view listing = option_symbol(i, buf);
+        Clock::time_point t0 = Clock::now();
+        const uint32_t id = registry->get_id(listing);
+        Clock::time_point t1 = Clock::now();
+        insert_ns[i] = ns_between(t0, t1);
+        ok &= id == i;
+        listed.store(i + 1, std::memory_order_release);
+
+        const std::size_t j = rng() % (i + 1);
+        std::string_view listed_symbol = option_symbol(j, buf);
+        t0 = Clock::now();
+        const uint32_t found = registry->get_id(listed_symbol);
+        t1 = Clock::now();
+        lookup_ns[i] = ns_between(t0, t1);
+        ok &= found == j;
+    }
+    total_s = total.elapsed_ms() / 1e3;
+    done.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+
+    reader_ns.clear();
+    for (unsigned r = 0; r < readers; ++r) {
+        ok &= good[r] != 0;
+        reader_ns.insert(reader_ns.end(), samples[r].begin(), samples[r].end());
+    }
+    for (std::size_t i = 0; i < symbols; i += symbols / 1000 + 1)
+        ok &= registry->get_symbol(static_cast<uint32_t>(i)) == option_symbol(i, buf);
+    return ok;
+}
+
+static int run_growth_scenario(std::size_t symbols, unsigned readers) {
+    std::cout << "\n---> [growth] 0 -> " << symbols
+              << " option listings; per step 1 new listing + 1 lookup of a listed one, "
+              << readers << " reader thread(s) looking up listed ones (ns)\n";
+    const int NW = 16;
+    const int OW = 9;
+    const int CW = 11;
+    const int TOTAL = NW + OW + CW * 6;
+    std::cout << std::left << std::setw(NW) << "Backend" << std::setw(OW) << "Call"
+              << std::right << std::setw(CW) << "calls" << std::setw(CW) << "p50"
+              << std::setw(CW) << "p99" << std::setw(CW) << "p99.99" << std::setw(CW) << "max"
+              << std::setw(CW) << "total (s)" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    std::vector<uint64_t> insert_ns, lookup_ns, reader_ns;
+    auto report = [&](const char* backend, bool ok, double total_s) {
+        if (!ok) {
+            std::cerr << "ERROR [growth]: " << backend << " returned wrong ids\n";
+            return false;
+        }
+        auto row = [&](const char* name, const char* call, std::vector<uint64_t>& ns) {
+            std::cout << std::left << std::setw(NW) << name << std::setw(OW) << call
+                      << std::right << std::setw(CW) << ns.size();
+            if (ns.empty()) {
+                for (int i = 0; i < 4; ++i) std::cout << std::setw(CW) << "-";
+            } else {
+                const LatencySummary s = summarize(ns);
+                std::cout << std::fixed << std::setprecision(0) << std::setw(CW) << s.p50
+                          << std::setw(CW) << s.p99 << std::setw(CW) << s.p9999 << std::setw(CW) << s.max;
+            }
+        };
+        row(backend, "insert", insert_ns);
+        std::cout << std::fixed << std::setprecision(2) << std::setw(CW) << total_s << "\n";
+        row("", "lookup", lookup_ns);
+        std::cout << "\n";
+        row("", "reader", reader_ns);
+        std::cout << "\n";
+        return true;
+    };
+
+    double total_s = 0;
+    bool ok = grow_and_time<LockedRegistry>(symbols, readers, insert_ns, lookup_ns, reader_ns, total_s);
+    if (!report(LockedRegistry::name, ok, total_s)) return 1;
+    ok = grow_and_time<RehashRegistry<false>>(symbols, readers, insert_ns, lookup_ns, reader_ns, total_s);
+    if (!report(RehashRegistry<false>::name, ok, total_s)) return 1;
+    ok = grow_and_time<RehashRegistry<true>>(symbols, readers, insert_ns, lookup_ns, reader_ns, total_s);
+    if (!report(RehashRegistry<true>::name, ok, total_s)) return 1;
+    std::cout << std::string(TOTAL, '-') << "\n";
+    return 0;
+}
+
+
+struct StormResult {
+    double writer_ms   = 0;   // writer alone, best of STORM_REPEATS
+    double reader_rate = 0;   // M lookups/s over all readers, writer running
+    bool   ok = false;
+};
+
+constexpr int STORM_REPEATS = 3;
+
+/* Lists `universe` in order (ids 0..n-1), then runs the writer stream on
+ * fresh registries: alone (best of STORM_REPEATS, so a 1% storm is not lost
+ * in timer noise), and once next to `readers` threads looping get_id over
+ * universe symbols until the writer is done. Readers check every id they
+ * get back. */
+template <typename Registry, typename Make>
+static StormResult storm_cell(Make make, const std::vector<std::string>& universe,
+                              const std::vector<std::string>& writes, std::size_t distinct,
+                              unsigned readers) {
+    StormResult r;
+    auto listed = [&] {
+        auto registry = make();
+        for (uint32_t i = 0; i < universe.size(); ++i)
+            if (registry->get_id(universe[i]) != i) return decltype(registry){};
+        return registry;
+    };
+
+    for (int rep = 0; rep < STORM_REPEATS; ++rep) {
+        auto alone = listed();
+        if (!alone) return r;
+        Timer<> writer;
+        for (const auto& s : writes) alone->get_id(s);
+        const double ms = writer.elapsed_ms();
+        if (alone->size() != distinct) return r;
+        r.writer_ms = rep == 0 ? ms : std::min(r.writer_ms, ms);
+    }
+
+    auto shared = listed();
+    const auto reads = generate_stream(universe, 65'536, 9);
+    std::vector<uint32_t> expected(reads.size());
+    for (std::size_t i = 0; i < reads.size(); ++i)
+        expected[i] = static_cast<uint32_t>(
+            std::find(universe.begin(), universe.end(), reads[i]) - universe.begin());
+
+    std::atomic<bool> go{false}, done{false};
+    std::vector<uint64_t> counts(readers, 0);
+    std::vector<char> good(readers, 0);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < readers; ++t)
+        pool.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            uint64_t n = 0;
+            bool ok = true;
+            for (std::size_t i = (t * 4099) % reads.size(); !done.load(std::memory_order_relaxed);
+                 i = i + 1 == reads.size() ? 0 : i + 1, ++n)
+                ok &= shared->get_id(reads[i]) == expected[i];
+            counts[t] = n;
+            good[t] = ok;
+        });
+    Timer<> timer;
+    go.store(true, std::memory_order_release);
+    for (const auto& s : writes) shared->get_id(s);
+    done.store(true, std::memory_order_relaxed);
+    const double ms = timer.elapsed_ms();
+    for (auto& th : pool) th.join();
+
+    uint64_t total = 0;
+    for (uint64_t n : counts) total += n;
+    r.reader_rate = static_cast<double>(total) / (ms * 1e3);
+    r.ok = shared->size() == distinct
+        && std::all_of(good.begin(), good.end(), [](char g) { return g != 0; });
+    for (std::size_t i = 0; r.ok && i < writes.size(); i += writes.size() / 4096 + 1)
+        r.ok = shared->get_symbol(shared->get_id(writes[i])) == writes[i];
+    return r;
+}
+
+static int run_storm_scenario(std::size_t lookups, unsigned max_threads,
+                              const std::vector<double>& fractions) {
+    const std::size_t UNIVERSE = 4096;
+    const unsigned READERS = std::max(1u, max_threads - 1);
+    const auto universe = generate_universe(UNIVERSE);
+
+    std::cout << "\n---> [storm] " << UNIVERSE << " listed symbols, 1 writer x " << lookups
+              << " get_id with new listings mixed in, " << READERS << " reader(s)\n";
+    const int NW = 16;
+    const int FW = 8;
+    const int CW = 15;
+    const int TOTAL = NW + FW + CW * 4;
+    std::cout << std::left << std::setw(NW) << "Backend" << std::right << std::setw(FW) << "New %"
+              << std::setw(CW) << "writer M/s" << std::setw(CW) << "ns / insert"
+              << std::setw(CW) << "readers M/s" << std::setw(CW) << "readers vs 0%" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    struct Storm {
+        double                   fraction;
+        std::vector<std::string> writes;
+        std::size_t              distinct;
+        std::size_t              inserts;
+    };
+    std::vector<Storm> storms;
+    for (double f : fractions) {
+        Storm st{f, generate_thread_streams(universe, 1, lookups, f)[0], 0, 0};
+        std::unordered_set<std::string_view> seen(universe.begin(), universe.end());
+        seen.insert(st.writes.begin(), st.writes.end());
+        st.distinct = seen.size();
+        st.inserts  = st.distinct - UNIVERSE;
+        storms.push_back(std::move(st));
+    }
+
+    auto sweep = [&](const char* backend, auto run) {
+        double quiet_ms = 0, quiet_rate = 0;
+        for (const Storm& st : storms) {
+            const StormResult r = run(st);
+            if (!r.ok) {
+                std::cerr << "ERROR [storm " << st.fraction * 100 << "%]: " << backend
+                          << " assigned inconsistent ids\n";
+                return false;
+            }
+            if (st.inserts == 0) {
+                quiet_ms   = r.writer_ms;
+                quiet_rate = r.reader_rate;
+            }
+            const double hits_ms = quiet_ms * static_cast<double>(lookups - st.inserts) / lookups;
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::left << std::setw(NW) << (st.fraction == storms[0].fraction ? backend : "")
+                      << std::right << std::setw(FW) << st.fraction * 100
+                      << std::setw(CW) << lookups / (r.writer_ms * 1e3);
+            if (st.inserts && quiet_ms > 0)
+                std::cout << std::setw(CW) << (r.writer_ms - hits_ms) * 1e6 / st.inserts;
+            else
+                std::cout << std::setw(CW) << "-";
+            std::cout << std::setw(CW) << r.reader_rate;
+            if (st.inserts && quiet_rate > 0)
+                std::cout << std::setw(CW - 1) << (r.reader_rate / quiet_rate - 1) * 100 << "%";
+            else
+                std::cout << std::setw(CW) << "-";
+            std::cout << "\n";
+        }
+        return true;
+    };
+
+    using Mode = AdaptiveRegistry::Mode;
+    auto adaptive = [&](Mode mode) {
+        return [&, mode](const Storm& st) {
+            return storm_cell<AdaptiveRegistry>(
+                [mode] { return std::make_unique<AdaptiveRegistry>(mode); },
+                universe, st.writes, st.distinct, READERS);
+        };
+    };
+    auto plain = [&](auto tag) {
+        using Registry = typename decltype(tag)::type;
+        return [&](const Storm& st) {
+            return storm_cell<Registry>([] { return std::make_unique<Registry>(); },
+                                        universe, st.writes, st.distinct, READERS);
+        };
+    };
+    struct Locked      { using type = LockedRegistry; };
+    struct Incremental { using type = RehashRegistry<true>; };
+
+    const bool ok = sweep(LockedRegistry::name, plain(Locked{}))
+                 && sweep(RehashRegistry<true>::name, plain(Incremental{}))
+                 && sweep(AdaptiveRegistry::mode_name(Mode::Flat), adaptive(Mode::Flat))
+                 && sweep(AdaptiveRegistry::mode_name(Mode::Sharded), adaptive(Mode::Sharded))
+                 && sweep(AdaptiveRegistry::mode_name(Mode::Adaptive), adaptive(Mode::Adaptive));
+    std::cout << std::string(TOTAL, '-') << "\n";
+    return ok ? 0 : 1;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::string SCENARIO = argc > 1 ? argv[1] : "all";
+    const std::size_t LOOKUPS =
+        argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 2'000'000;
+    const unsigned MAX_THREADS =
+        argc > 3 ? static_cast<unsigned>(std::atoi(argv[3]))
+                 : std::max(4u, std::thread::hardware_concurrency());
+
+    const std::size_t GROWTH_SYMBOLS = argc > 2 ? LOOKUPS : 10'000'000;
+    const std::vector<double> STORM_FRACTIONS =
+        argc > 4 ? std::vector<double>{0.0, std::atof(argv[4]) / 100}
+                 : std::vector<double>{0.0, 0.01, 0.10, 0.50};
+
+    if (SCENARIO != "all" && SCENARIO != "scan" && SCENARIO != "adaptive" && SCENARIO != "growth"
+        && SCENARIO != "storm") {
+        std::cerr << "Usage: " << argv[0]
+                  << " [all|scan|adaptive|growth|storm] [lookups] [max_threads] [new_percent]\n";
+        return 1;
+    }
+
+    std::cout << "micrometrics - symbol registry backends\n"
+              << "Lookups    : " << LOOKUPS << " get_id per cell\n"
+              << "Threads    : 1 to " << MAX_THREADS << " (adaptive)\n";
+
+    int rc = 0;
+    if (rc == 0 && (SCENARIO == "all" || SCENARIO == "scan"))
+        rc = run_scan_scenario(LOOKUPS);
+    if (rc == 0 && (SCENARIO == "all" || SCENARIO == "adaptive"))
+        rc = run_adaptive_scenario(LOOKUPS, MAX_THREADS);
+    if (rc == 0 && (SCENARIO == "all" || SCENARIO == "growth"))
+        rc = run_growth_scenario(GROWTH_SYMBOLS, std::max(1u, MAX_THREADS - 1));
+    if (rc == 0 && (SCENARIO == "all" || SCENARIO == "storm"))
+        rc = run_storm_scenario(LOOKUPS, MAX_THREADS, STORM_FRACTIONS);
+    std::cout << "\n";
+    return rc;
+}
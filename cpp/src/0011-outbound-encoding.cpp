@@ -0,0 +1,422 @@
+/* micrometrics : Outbound Symbol Encoding - id to wire bytes
+ *
+ * The 0001 registry turns inbound symbols into ids; the outbound side turns
+ * them back into bytes when an order is sent. get_symbol(id) returns
+ * id_to_string_.at(id), a bounds-checked std::string, and the encoder then
+ * copies and pads it. Ways to fill the symbol field of an outbound order:
+ *
+ *   raw string        the order carries its own std::string symbol
+ *   get_symbol .at    the order carries an id; get_symbol(id), bounds checked
+ *   get_symbol []     same, id_to_string_[id] without the check
+ *   encoded .at       the order carries an id; the field bytes were encoded
+ *                     once per symbol at listing time and are copied as is,
+ *                     after an explicit id < size check
+ *   encoded []        same, no check
+ *
+ * Wire formats
+ *   FIX     tag 55 after a constant "8=FIX.4.4|35=D|" header:
+ *           "55=<symbol>\x01". Pre-encoded in a FIX_SLOT-byte slot per id:
+ *           a length byte, then the field, zero padded. The encoder always
+ *           copies the whole slot tail and advances by the length, so the
+ *           copy size never depends on the (possibly cache-missing) length.
+ *   binary  OUCH-style frame: type byte, FIELD_WIDTH space-padded symbol
+ *           bytes, uint32 quantity, int64 price. Pre-encoded as
+ *           FIELD_WIDTH bytes per id in one array.
+ *
+ * Scenario
+ *   Universe 45 tickers (0001 symbol pool) and 100 000 19-char option
+ *   symbols (past the SSO buffer, so each raw-string order points at its
+ *   own heap block). `orders` orders are drawn uniformly from the universe
+ *   and encoded into a ring of RING 64-byte frames. Reported: ns per
+ *   order, and order sizes. Every method must write the same bytes into
+ *   every frame (bytes past a frame's length are not part of the message).
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o 0011-outbound-encoding 0011-outbound-encoding.cpp
+ *
+ * Run:
+ *   ./0011-outbound-encoding [orders]
+ *   default: orders=2 000 000 per cell
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------
+// Registry and pre-encoded fields
+// ---------------------------------------------------------------------------
+// The 0001 registry, plus unchecked reverse lookup.
+class SymbolRegistry {
+private:
+    std::unordered_map<std::string, uint32_t> string_to_id_;
+    std::vector<std::string>                  id_to_string_;
+    std::mutex                                mtx;
+
+public:
+    uint32_t get_id(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string key(symbol);
+        auto it = string_to_id_.find(key);
+        if (it != string_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
+        string_to_id_[key] = new_id;
+        id_to_string_.emplace_back(symbol);
+        return new_id;
+    }
+
+    inline std::string_view get_symbol(uint32_t id) const {
+        return id_to_string_.at(id);
+    }
+
+    // Caller guarantees id < size().
+    inline std::string_view get_symbol_unchecked(uint32_t id) const {
+        return id_to_string_[id];
+    }
+
+    std::size_t size() const { return id_to_string_.size(); }
+};
+
+constexpr std::size_t FIELD_WIDTH = 24;   // binary symbol field, space padded
+constexpr std::size_t FIX_SLOT    = 32;   // length byte + "55=<symbol>\x01", zero padded
+constexpr char        SOH         = '\x01';
+
+/* Symbol fields encoded once per id, in id order. Symbols longer than
+ * FIELD_WIDTH throw std::length_error. put_fix writes FIX_SLOT - 1 bytes
+ * whatever the field length, so `out` needs that much room. */
+class OutboundEncodings {
+private:
+    std::vector<char> fix_;      // per id: FIX_SLOT bytes
+    std::vector<char> binary_;   // per id: FIELD_WIDTH bytes
+    std::size_t       size_ = 0;
+
+    void check(uint32_t id) const {
+        if (id >= size_) throw std::out_of_range("OutboundEncodings: unknown id");
+    }
+
+public:
+    void add(std::string_view symbol) {
+        static_assert(FIELD_WIDTH + 5 <= FIX_SLOT, "FIX slot too small for the widest symbol");
+        if (symbol.size() > FIELD_WIDTH) throw std::length_error("OutboundEncodings: symbol too long");
+        const std::size_t at = fix_.size();
+        fix_.resize(at + FIX_SLOT, 0);
+        fix_[at] = static_cast<char>(symbol.size() + 4);
+        std::memcpy(&fix_[at + 1], "55=", 3);
+        std::memcpy(&fix_[at + 4], symbol.data(), symbol.size());
+        fix_[at + 4 + symbol.size()] = SOH;
+
+        binary_.insert(binary_.end(), symbol.begin(), symbol.end());
+        binary_.insert(binary_.end(), FIELD_WIDTH - symbol.size(), ' ');
+        ++size_;
+    }
+
+    // Copies the FIX field for `id` to `out`; returns the end of the field.
+    template <bool Checked>
+    char* put_fix(uint32_t id, char* out) const {
+        if constexpr (Checked) check(id);
+        const char* slot = fix_.data() + static_cast<std::size_t>(id) * FIX_SLOT;
+        std::memcpy(out, slot + 1, FIX_SLOT - 1);
+        return out + static_cast<unsigned char>(slot[0]);
+    }
+
+    template <bool Checked>
+    char* put_binary(uint32_t id, char* out) const {
+        if constexpr (Checked) check(id);
+        std::memcpy(out, binary_.data() + static_cast<std::size_t>(id) * FIELD_WIDTH, FIELD_WIDTH);
+        return out + FIELD_WIDTH;
+    }
+
+    std::size_t size() const { return size_; }
+};
+
+// Encodes the fields from the symbol text, as done for a raw-string order.
+static char* put_fix_text(std::string_view symbol, char* out) {
+    std::memcpy(out, "55=", 3);
+    std::memcpy(out + 3, symbol.data(), symbol.size());
+    out[3 + symbol.size()] = SOH;
+    return out + 4 + symbol.size();
+}
+
+static char* put_binary_text(std::string_view symbol, char* out) {
+    std::memcpy(out, symbol.data(), symbol.size());
+    std::memset(out + symbol.size(), ' ', FIELD_WIDTH - symbol.size());
+    return out + FIELD_WIDTH;
+}
+
+
+// ---------------------------------------------------------------------------
+// Orders and frames
+// ---------------------------------------------------------------------------
+struct IdOrder {
+    uint32_t symbol_id;
+    uint32_t quantity;
+    int64_t  price;
+};
+
+struct StringOrder {
+    std::string symbol;
+    uint32_t    quantity;
+    int64_t     price;
+};
+
+constexpr std::size_t FRAME = 64;
+constexpr std::size_t RING  = 4096;
+constexpr char        FIX_HEADER[] = "8=FIX.4.4\x01" "35=D\x01";
+constexpr std::size_t FIX_HEADER_LEN = sizeof(FIX_HEADER) - 1;
+
+static_assert(FIX_HEADER_LEN + FIX_SLOT - 1 <= FRAME, "FIX frame overflows");
+
+// Frames of the ring and the message length last written to each.
+struct Ring {
+    std::vector<char>        bytes = std::vector<char>(RING * FRAME);
+    std::vector<std::size_t> length = std::vector<std::size_t>(RING);
+
+    char* frame(std::size_t i) { return bytes.data() + (i % RING) * FRAME; }
+
+    bool same_messages(const Ring& o) const {
+        for (std::size_t f = 0; f < RING; ++f)
+            if (length[f] != o.length[f]
+                    || std::memcmp(&bytes[f * FRAME], &o.bytes[f * FRAME], length[f]) != 0)
+                return false;
+        return true;
+    }
+};
+
+// Writes one FIX frame; `put` fills the symbol field. Returns bytes written.
+template <typename Put>
+static std::size_t fix_frame(char* frame, Put put) {
+    std::memcpy(frame, FIX_HEADER, FIX_HEADER_LEN);
+    return static_cast<std::size_t>(put(frame + FIX_HEADER_LEN) - frame);
+}
+
+template <typename Put>
+static std::size_t binary_frame(char* frame, uint32_t quantity, int64_t price, Put put) {
+    frame[0] = 'O';
+    char* p = put(frame + 1);
+    std::memcpy(p, &quantity, sizeof(quantity));
+    std::memcpy(p + sizeof(quantity), &price, sizeof(price));
+    return 1 + FIELD_WIDTH + sizeof(quantity) + sizeof(price);
+}
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+static const std::vector<std::string> SYMBOL_POOL = {
+    "AAPL", "MSFT", "GOOGL", "AMZN", "NVDA", "TSLA", "META", "BRK.B", "JPM",  "V",
+    "SPY",  "QQQ",  "IWM",   "DIA",  "GLD",  "TLT",  "VTI",  "EEM",   "XLF",  "HYG",
+    "EURUSD", "GBPUSD", "USDJPY", "USDCHF", "AUDUSD",
+    "NZDUSD", "USDCAD", "EURGBP", "EURJPY", "GBPJPY",
+    "ES",  "NQ",  "CL",  "GC",  "SI", "NG",  "ZB",  "ZN",  "ZC",  "ZS",
+    "BTCUSD", "ETHUSD", "SOLUSD", "BNBUSD", "XRPUSD",
+};
+
+// OCC-style option symbols: 4-letter root, expiry, C/P, 8-digit strike.
+static std::vector<std::string> generate_option_universe(std::size_t n) {
+    std::vector<std::string> universe;
+    universe.reserve(n);
+    char buf[32];
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t root = i / 2'000;
+        std::snprintf(buf, sizeof(buf), "%c%c%c%c26%02zu18%c%08zu",
+                      static_cast<char>('A' + root / 17'576 % 26), static_cast<char>('A' + root / 676 % 26),
+                      static_cast<char>('A' + root / 26 % 26), static_cast<char>('A' + root % 26),
+                      (i / 200) % 10 + 1, i % 2 ? 'P' : 'C', (i / 2 % 100 + 1) * 500);
+        universe.emplace_back(buf);
+    }
+    return universe;
+}
+
+struct Cell {
+    double      ns_per_order;
+    std::size_t bytes;   // total bytes written
+};
+
+template <typename Orders, typename Encode>
+static Cell run_cell(const Orders& orders, Ring& ring, Encode encode) {
+    for (std::size_t i = 0; i < std::min<std::size_t>(orders.size(), RING); ++i)   // warm-up
+        encode(orders[i], ring.frame(i));
+    std::size_t bytes = 0;
+    Timer<> t;
+    for (std::size_t i = 0; i < orders.size(); ++i)
+        bytes += encode(orders[i], ring.frame(i));
+    const double ms = t.elapsed_ms();
+    for (std::size_t i = orders.size() > RING ? orders.size() - RING : 0; i < orders.size(); ++i)
+        ring.length[i % RING] = encode(orders[i], ring.frame(i));
+    return {ms * 1e6 / static_cast<double>(orders.size()), bytes};
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t ORDERS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+
+    std::cout << "micrometrics - outbound symbol encoding: id to wire bytes\n"
+              << "Orders     : " << ORDERS << " per cell, ring of " << RING << " x "
+              << FRAME << " B frames\n"
+              << "Order size : IdOrder " << sizeof(IdOrder) << " B, StringOrder "
+              << sizeof(StringOrder) << " B (+ heap block past the SSO buffer)\n";
+
+    const int MW = 22;
+    const int CW = 14;
+    const int TOTAL = MW + CW * 2;
+    const char* methods[5] = {"raw string", "get_symbol .at", "get_symbol []",
+                              "encoded .at", "encoded []"};
+
+    struct Universe {
+        const char*              name;
+        std::vector<std::string> symbols;
+    };
+    for (const Universe& u : {Universe{"45 tickers", SYMBOL_POOL},
+                              Universe{"100000 options", generate_option_universe(100'000)}}) {
+        SymbolRegistry registry;
+        OutboundEncodings encodings;
+        for (const auto& s : u.symbols) {
+            if (registry.get_id(s) == encodings.size()) encodings.add(s);
+        }
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<std::size_t> pick(0, u.symbols.size() - 1);
+        std::vector<IdOrder>     id_orders;
+        std::vector<StringOrder> string_orders;
+        id_orders.reserve(ORDERS);
+        string_orders.reserve(ORDERS);
+        for (std::size_t i = 0; i < ORDERS; ++i) {
+            const std::size_t k = pick(rng);
+            const uint32_t quantity = static_cast<uint32_t>(100 * (1 + i % 10));
+            const int64_t  price    = static_cast<int64_t>(1'000'000 + i % 5'000);
+            id_orders.push_back({registry.get_id(u.symbols[k]), quantity, price});
+            string_orders.push_back({u.symbols[k], quantity, price});
+        }
+
+        std::cout << "\n---> " << u.name << "  (ns per order)\n";
+        std::cout << std::left << std::setw(MW) << "Method" << std::right
+                  << std::setw(CW) << "FIX 55=" << std::setw(CW) << "binary" << "\n";
+        std::cout << std::string(TOTAL, '-') << "\n";
+
+        Ring ring, reference_fix, reference_binary;
+        std::size_t bytes_fix = 0, bytes_binary = 0;
+        for (int m = 0; m < 5; ++m) {
+            Cell fix{}, binary{};
+            switch (m) {
+                case 0:
+                    fix = run_cell(string_orders, ring, [](const StringOrder& o, char* f) {
+                        return fix_frame(f, [&](char* p) { return put_fix_text(o.symbol, p); });
+                    });
+                    break;
+                case 1:
+                    fix = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return fix_frame(f, [&](char* p) {
+                            return put_fix_text(registry.get_symbol(o.symbol_id), p);
+                        });
+                    });
+                    break;
+                case 2:
+                    fix = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return fix_frame(f, [&](char* p) {
+                            return put_fix_text(registry.get_symbol_unchecked(o.symbol_id), p);
+                        });
+                    });
+                    break;
+                case 3:
+                    fix = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return fix_frame(f, [&](char* p) { return encodings.put_fix<true>(o.symbol_id, p); });
+                    });
+                    break;
+                case 4:
+                    fix = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return fix_frame(f, [&](char* p) { return encodings.put_fix<false>(o.symbol_id, p); });
+                    });
+                    break;
+            }
+            if (m == 0) {
+                reference_fix = ring;
+                bytes_fix = fix.bytes;
+            }
+            const bool fix_ok = ring.same_messages(reference_fix) && fix.bytes == bytes_fix;
+
+            switch (m) {
+                case 0:
+                    binary = run_cell(string_orders, ring, [](const StringOrder& o, char* f) {
+                        return binary_frame(f, o.quantity, o.price,
+                                            [&](char* p) { return put_binary_text(o.symbol, p); });
+                    });
+                    break;
+                case 1:
+                    binary = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return binary_frame(f, o.quantity, o.price, [&](char* p) {
+                            return put_binary_text(registry.get_symbol(o.symbol_id), p);
+                        });
+                    });
+                    break;
+                case 2:
+                    binary = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return binary_frame(f, o.quantity, o.price, [&](char* p) {
+                            return put_binary_text(registry.get_symbol_unchecked(o.symbol_id), p);
+                        });
+                    });
+                    break;
+                case 3:
+                    binary = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return binary_frame(f, o.quantity, o.price, [&](char* p) {
+                            return encodings.put_binary<true>(o.symbol_id, p);
+                        });
+                    });
+                    break;
+                case 4:
+                    binary = run_cell(id_orders, ring, [&](const IdOrder& o, char* f) {
+                        return binary_frame(f, o.quantity, o.price, [&](char* p) {
+                            return encodings.put_binary<false>(o.symbol_id, p);
+                        });
+                    });
+                    break;
+            }
+            if (m == 0) {
+                reference_binary = ring;
+                bytes_binary = binary.bytes;
+            }
+            if (!fix_ok || !ring.same_messages(reference_binary) || binary.bytes != bytes_binary) {
+                std::cerr << "ERROR [" << u.name << "]: " << methods[m]
+                          << " wrote different bytes than the raw string\n";
+                return 1;
+            }
+
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::left << std::setw(MW) << methods[m] << std::right
+                      << std::setw(CW) << fix.ns_per_order
+                      << std::setw(CW) << binary.ns_per_order << "\n";
+        }
+        std::cout << std::string(TOTAL, '-') << "\n";
+    }
+
+    std::cout << "\n";
+    return 0;
+}
@@ -0,0 +1,689 @@
+/* micrometrics : Shared-memory Symbol Registry
+ *
+ * Every process that builds its own 0001 registry numbers symbols in the
+ * order it happens to see them, so a feed handler, a strategy and a risk
+ * process disagree on ids. SharedRegistry lives in one POSIX shared-memory
+ * segment that every process maps:
+ *
+ *   header   magic, capacity, layout offsets, the atomic id counter and
+ *            the atomic arena fill level, each on its own cache line
+ *   entries  per id: arena offset and length of the symbol
+ *   index    open-addressing hash index, 2 slots per id (power of two),
+ *            one 64-bit atomic word per slot: (hash >> 32) << 32 | id + 1,
+ *            0 = empty; linear probing
+ *   arena    append-only symbol bytes
+ *
+ * Everything is addressed by offset, so each process may map the segment at
+ * a different address. Lookups are plain loads with no lock and no system
+ * call. get_id on a miss reserves an id and arena bytes with fetch_add,
+ * writes the bytes and the entry, then publishes the id with a CAS on an
+ * empty index slot (release; readers load slots with acquire). A writer
+ * that loses the slot to the same symbol returns the winner's id, so every
+ * symbol has exactly one id in every process; the loser's id is left
+ * unused, a rare gap in the id range. Nothing blocks: a writer that dies
+ * mid-insert leaves at most an unused id and some arena bytes. The segment
+ * has a fixed capacity (std::length_error once ids or arena run out).
+ *
+ * Scenarios
+ *   [lookup]   one process, universe of 4096 tickers and of 100 000 option
+ *              symbols, all listed before timing; get_id over `lookups`
+ *              std::string copies. SharedRegistry vs the 0001 registry
+ *              (std::mutex + std::unordered_map). Reported: ns per lookup.
+ *   [agree]    P = 1, 2, 4, ... N forked processes open the segment by name
+ *              and list the same `lookups` / 10 new symbols at the same
+ *              time, each in its own shuffled order. Reported: M get_id/s
+ *              over all processes, and the id gaps; every process must get
+ *              the same id for every symbol.
+ *   [readers]  4096 tickers listed; R = 1, 2, 4, ... N - 1 reader
+ *              processes run `lookups` get_id each, alone and while one
+ *              writer process lists new symbols until they finish.
+ *              Reported: reader ns per lookup and writer M inserts/s.
+ *
+ * Build (POSIX):
+ *   g++ -std=c++17 -O2 -o 0012-shared-memory-registry 0012-shared-memory-registry.cpp
+ *   (add -lrt on glibc older than 2.34)
+ *
+ * Run:
+ *   ./0012-shared-memory-registry [lookups] [max_processes]
+ *   default: lookups=2 000 000 per cell,
+ *            max_processes=std::thread::hardware_concurrency() (at least 4)
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+constexpr uint32_t NIL = UINT32_MAX;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared index words must be lock-free (address-free) atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared id counter must be a lock-free (address-free) atomic");
+
+// FNV-1a with a murmur3 finalizer: the same value in every process and binary.
+static uint64_t hash_symbol(std::string_view symbol) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : symbol) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+static std::size_t align64(std::size_t n) { return (n + 63) & ~std::size_t{63}; }
+
+
+// ---------------------------------------------------------------------------
+// Shared-memory registry
+// ---------------------------------------------------------------------------
+class SharedRegistry {
+private:
+    static constexpr uint64_t MAGIC = 0x3231'3030'4D4D'5253ull;   // "SRMM0012"
+
+    struct Header {
+        uint64_t magic;
+        uint64_t bytes;
+        uint32_t capacity;
+        uint32_t index_mask;
+        uint64_t arena_bytes;
+        uint64_t entries_at, index_at, arena_at;
+        alignas(64) std::atomic<uint32_t> next_id{0};
+        alignas(64) std::atomic<uint64_t> arena_used{0};
+    };
+
+    struct Entry {
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    void*                  base_  = nullptr;
+    std::size_t            bytes_ = 0;
+    Header*                header_  = nullptr;
+    Entry*                 entries_ = nullptr;
+    std::atomic<uint64_t>* index_   = nullptr;
+    char*                  arena_   = nullptr;
+
+    static std::system_error os_error(const char* what) {
+        return std::system_error(errno, std::generic_category(), what);
+    }
+
+    SharedRegistry(void* base, std::size_t bytes) : base_(base), bytes_(bytes) {
+        char* p  = static_cast<char*>(base);
+        header_  = static_cast<Header*>(base);
+        entries_ = reinterpret_cast<Entry*>(p + header_->entries_at);
+        index_   = reinterpret_cast<std::atomic<uint64_t>*>(p + header_->index_at);
+        arena_   = p + header_->arena_at;
+    }
+
+    static void* map(int fd, std::size_t bytes) {
+        void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) throw os_error("mmap");
+        return base;
+    }
+
+    bool same(uint32_t id, std::string_view symbol) const {
+        const Entry& e = entries_[id];
+        return e.length == symbol.size() && std::memcmp(arena_ + e.offset, symbol.data(), e.length) == 0;
+    }
+
+    // Writes the symbol and its entry under a fresh id; not yet indexed.
+    uint32_t reserve(std::string_view symbol) {
+        const uint32_t id = header_->next_id.fetch_add(1, std::memory_order_relaxed);
+        if (id >= header_->capacity) throw std::length_error("SharedRegistry: no free id");
+        const uint64_t at = header_->arena_used.fetch_add(symbol.size(), std::memory_order_relaxed);
+        if (at + symbol.size() > header_->arena_bytes)
+            throw std::length_error("SharedRegistry: arena full");
+        std::memcpy(arena_ + at, symbol.data(), symbol.size());
+        entries_[id] = {at, static_cast<uint32_t>(symbol.size())};
+        return id;
+    }
+
+public:
+    /* Creates the segment `name` ("/something") for up to `capacity`
+     * symbols and `arena_bytes` of symbol text; fails if it exists. */
+    static SharedRegistry create(const std::string& name, uint32_t capacity, uint64_t arena_bytes) {
+        std::size_t slots = 1;
+        while (slots < 2 * static_cast<std::size_t>(capacity)) slots *= 2;
+        const std::size_t entries_at = align64(sizeof(Header));
+        const std::size_t index_at   = align64(entries_at + sizeof(Entry) * capacity);
+        const std::size_t arena_at   = align64(index_at + sizeof(std::atomic<uint64_t>) * slots);
+        const std::size_t bytes      = align64(arena_at + arena_bytes);
+
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw os_error("shm_open");
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            const std::system_error error = os_error("ftruncate");
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw error;
+        }
+        void* base = map(fd, bytes);
+
+        Header* h = new (base) Header;
+        h->bytes       = bytes;
+        h->capacity    = capacity;
+        h->index_mask  = static_cast<uint32_t>(slots - 1);
+        h->arena_bytes = arena_bytes;
+        h->entries_at  = entries_at;
+        h->index_at    = index_at;
+        h->arena_at    = arena_at;
+        char* p = static_cast<char*>(base);
+        for (std::size_t i = 0; i < slots; ++i)
+            new (p + index_at + i * sizeof(std::atomic<uint64_t>)) std::atomic<uint64_t>(0);
+        std::atomic_thread_fence(std::memory_order_release);
+        h->magic = MAGIC;
+        return SharedRegistry(base, bytes);
+    }
+
+    // Maps an existing segment created by create().
+    static SharedRegistry open(const std::string& name) {
+        const int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) throw os_error("shm_open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const std::system_error error = os_error("fstat");
+            ::close(fd);
+            throw error;
+        }
+        const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+        void* base = map(fd, bytes);
+        const Header* h = static_cast<const Header*>(base);
+        if (bytes < sizeof(Header) || h->magic != MAGIC || h->bytes != bytes) {
+            ::munmap(base, bytes);
+            throw std::runtime_error("SharedRegistry: " + name + " is not a registry segment");
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return SharedRegistry(base, bytes);
+    }
+
+    // Removes the name; mappings stay valid until every process unmaps.
+    static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    SharedRegistry(SharedRegistry&& o) noexcept
+        : base_(o.base_), bytes_(o.bytes_), header_(o.header_), entries_(o.entries_),
+          index_(o.index_), arena_(o.arena_) {
+        o.base_ = nullptr;
+    }
+    SharedRegistry(const SharedRegistry&) = delete;
+    SharedRegistry& operator=(const SharedRegistry&) = delete;
+    SharedRegistry& operator=(SharedRegistry&&) = delete;
+
+    ~SharedRegistry() {
+        if (base_) ::munmap(base_, bytes_);
+    }
+
+    // Id of `symbol`, or NIL when no process has listed it.
+    uint32_t find(std::string_view symbol) const {
+        const uint64_t h   = hash_symbol(symbol);
+        const uint64_t tag = h >> 32;
+        const uint32_t mask = header_->index_mask;
+        for (uint32_t i = static_cast<uint32_t>(h) & mask;; i = (i + 1) & mask) {
+            const uint64_t w = index_[i].load(std::memory_order_acquire);
+            if (w == 0) return NIL;
+            const uint32_t id = static_cast<uint32_t>(w) - 1;
+            if ((w >> 32) == tag && same(id, symbol)) return id;
+        }
+    }
+
+    uint32_t get_id(std::string_view symbol) {
+        const uint64_t h   = hash_symbol(symbol);
+        const uint64_t tag = h >> 32;
+        const uint32_t mask = header_->index_mask;
+        uint32_t mine = NIL;
+        for (uint32_t i = static_cast<uint32_t>(h) & mask;; i = (i + 1) & mask) {
+            uint64_t w = index_[i].load(std::memory_order_acquire);
+            if (w == 0) {
+                if (mine == NIL) mine = reserve(symbol);
+                const uint64_t word = (tag << 32) | (static_cast<uint64_t>(mine) + 1);
+                if (index_[i].compare_exchange_strong(w, word, std::memory_order_acq_rel,
+                                                      std::memory_order_acquire))
+                    return mine;
+                // Another writer took the slot first: `w` is its word.
+            }
+            const uint32_t id = static_cast<uint32_t>(w) - 1;
+            if ((w >> 32) == tag && same(id, symbol)) return id;
+        }
+    }
+
+    // Valid for any id returned by get_id or find, in any process.
+    std::string_view get_symbol(uint32_t id) const {
+        const Entry& e = entries_[id];
+        return {arena_ + e.offset, e.length};
+    }
+
+    // Ids handed out so far, including the rare unused ones.
+    std::size_t size() const {
+        return std::min<std::size_t>(header_->next_id.load(std::memory_order_acquire),
+                                     header_->capacity);
+    }
+};
+
+
+// The 0001 registry, single process.
+class LockedRegistry {
+private:
+    std::unordered_map<std::string, uint32_t> string_to_id_;
+    std::vector<std::string>                  id_to_string_;
+    std::mutex                                mtx;
+
+public:
+    uint32_t get_id(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string key(symbol);
+        auto it = string_to_id_.find(key);
+        if (it != string_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
+        string_to_id_[key] = new_id;
+        id_to_string_.emplace_back(symbol);
+        return new_id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return id_to_string_.at(id); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Processes
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+// Anonymous shared mapping, inherited by forked children.
+template <typename T>
+class SharedArray {
+private:
+    T*          data_;
+    std::size_t n_;
+
+public:
+    explicit SharedArray(std::size_t n) : n_(n) {
+        void* p = ::mmap(nullptr, sizeof(T) * n, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+        data_ = static_cast<T*>(p);
+        for (std::size_t i = 0; i < n; ++i) new (data_ + i) T();
+    }
+    ~SharedArray() { ::munmap(data_, sizeof(T) * n_); }
+    SharedArray(const SharedArray&) = delete;
+    SharedArray& operator=(const SharedArray&) = delete;
+
+    T& operator[](std::size_t i) { return data_[i]; }
+    T* data() { return data_; }
+};
+
+struct ChildResult {
+    double   ms     = 0;
+    uint64_t count  = 0;
+    uint64_t sum    = 0;
+    int      failed = 0;
+};
+
+struct Control {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool>     go{false};
+    std::atomic<bool>     stop{false};
+};
+
+using Body = std::function<void(SharedRegistry&, ChildResult&, Control&)>;
+
+/* Forks one child per body; each opens the segment `name`, waits for the
+ * common start and runs body(registry, result, control). A child that fails
+ * before the start still checks in as ready so the parent never waits on
+ * it. Returns false if a child failed or did not exit cleanly. */
+static bool run_processes(const std::string& name, const std::vector<Body>& bodies,
+                          SharedArray<ChildResult>& results) {
+    SharedArray<Control> control(1);
+    std::vector<pid_t> children;
+    std::cout.flush();
+    for (std::size_t c = 0; c < bodies.size(); ++c) {
+        const pid_t pid = ::fork();
+        if (pid < 0) throw std::system_error(errno, std::generic_category(), "fork");
+        if (pid == 0) {
+            int code = 0;
+            bool checked_in = false;
+            try {
+                SharedRegistry registry = SharedRegistry::open(name);
+                control[0].ready.fetch_add(1, std::memory_order_acq_rel);
+                checked_in = true;
+                while (!control[0].go.load(std::memory_order_acquire)) std::this_thread::yield();
+                bodies[c](registry, results[c], control[0]);
+            } catch (const std::exception& e) {
+                std::cerr << "ERROR [child " << c << "]: " << e.what() << "\n";
+                results[c].failed = 1;
+                code = 1;
+                if (!checked_in) control[0].ready.fetch_add(1, std::memory_order_acq_rel);
+            }
+            ::_exit(code);
+        }
+        children.push_back(pid);
+    }
+    while (control[0].ready.load(std::memory_order_acquire) < bodies.size()) std::this_thread::yield();
+    control[0].go.store(true, std::memory_order_release);
+
+    bool ok = true;
+    for (pid_t pid : children) {
+        int status = 0;
+        if (::waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            ok = false;
+    }
+    for (std::size_t c = 0; c < bodies.size(); ++c) ok &= results[c].failed == 0;
+    return ok;
+}
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+static std::vector<std::string> generate_tickers(std::size_t n, unsigned seed = 7) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> length(3, 8);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> universe;
+    while (universe.size() < n) {
+        std::string s(static_cast<std::size_t>(length(rng)), ' ');
+        for (char& c : s) c = static_cast<char>(letter(rng));
+        if (seen.insert(s).second) universe.push_back(std::move(s));
+    }
+    return universe;
+}
+
+// OCC-style option symbols: 4-letter root, expiry, C/P, 8-digit strike.
+static std::vector<std::string> generate_options(std::size_t n) {
+    std::vector<std::string> universe;
+    universe.reserve(n);
+    char buf[32];
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t root = i / 2'000;
+        std::snprintf(buf, sizeof(buf), "%c%c%c%c26%02zu18%c%08zu",
+                      static_cast<char>('A' + root / 17'576 % 26), static_cast<char>('A' + root / 676 % 26),
+                      static_cast<char>('A' + root / 26 % 26), static_cast<char>('A' + root % 26),
+                      (i / 200) % 10 + 1, i % 2 ? 'P' : 'C', (i / 2 % 100 + 1) * 500);
+        universe.emplace_back(buf);
+    }
+    return universe;
+}
+
+static std::vector<std::string> generate_stream(const std::vector<std::string>& universe,
+                                                std::size_t n, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, universe.size() - 1);
+    std::vector<std::string> stream;
+    stream.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) stream.push_back(universe[pick(rng)]);
+    return stream;
+}
+
+static std::string segment_name(const char* scenario) {
+    return "/micrometrics-0012-" + std::to_string(::getpid()) + "-" + scenario;
+}
+
+static uint64_t text_bytes(const std::vector<std::string>& symbols) {
+    uint64_t n = 0;
+    for (const auto& s : symbols) n += s.size();
+    return n;
+}
+
+static int run_lookup_scenario(std::size_t lookups) {
+    std::cout << "\n---> [lookup] get_id on a fully listed universe, 1 process (ns per lookup)\n";
+    const int UW = 18;
+    const int CW = 16;
+    const int TOTAL = UW + CW * 2;
+    std::cout << std::left << std::setw(UW) << "Universe" << std::right
+              << std::setw(CW) << "shared" << std::setw(CW) << "0001 registry" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    struct Universe {
+        const char*              name;
+        std::vector<std::string> symbols;
+    };
+    for (const Universe& u : {Universe{"4096 tickers", generate_tickers(4096)},
+                              Universe{"100000 options", generate_options(100'000)}}) {
+        const auto stream = generate_stream(u.symbols, lookups);
+        const std::string name = segment_name("lookup");
+        SharedRegistry shared = SharedRegistry::create(
+            name, static_cast<uint32_t>(u.symbols.size()), text_bytes(u.symbols));
+        SharedRegistry::unlink(name);
+        LockedRegistry locked;
+        for (const auto& s : u.symbols) {
+            if (shared.get_id(s) != locked.get_id(s)) {
+                std::cerr << "ERROR [lookup " << u.name << "]: registries disagree on ids\n";
+                return 1;
+            }
+        }
+
+        uint64_t sum_shared = 0, sum_locked = 0;
+        Timer<> ts;
+        for (const auto& s : stream) sum_shared += shared.get_id(s);
+        const double ms_shared = ts.elapsed_ms();
+        Timer<> tl;
+        for (const auto& s : stream) sum_locked += locked.get_id(s);
+        const double ms_locked = tl.elapsed_ms();
+        if (sum_shared != sum_locked || shared.get_symbol(shared.find(u.symbols.back())) != u.symbols.back()) {
+            std::cerr << "ERROR [lookup " << u.name << "]: registries disagree on ids\n";
+            return 1;
+        }
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::left << std::setw(UW) << u.name << std::right
+                  << std::setw(CW) << ms_shared * 1e6 / static_cast<double>(lookups)
+                  << std::setw(CW) << ms_locked * 1e6 / static_cast<double>(lookups) << "\n";
+    }
+    std::cout << std::string(TOTAL, '-') << "\n";
+    return 0;
+}
+
+static int run_agree_scenario(std::size_t lookups, unsigned max_processes) {
+    const std::size_t N = std::max<std::size_t>(1, lookups / 10);
+    std::vector<std::string> listings;
+    listings.reserve(N);
+    for (std::size_t i = 0; i < N; ++i) listings.push_back("NEW" + std::to_string(i));
+
+    std::cout << "\n---> [agree] P processes list the same " << N
+              << " new symbols concurrently, each in its own order\n";
+    const int PW = 12;
+    const int CW = 16;
+    const int TOTAL = PW + CW * 3;
+    std::cout << std::right << std::setw(PW) << "Processes" << std::setw(CW) << "M get_id/s"
+              << std::setw(CW) << "ids used" << std::setw(CW) << "id gaps" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    for (unsigned procs = 1; procs <= max_processes; procs *= 2) {
+        const std::string name = segment_name("agree");
+        SharedRegistry registry =
+            SharedRegistry::create(name, static_cast<uint32_t>(N * procs), text_bytes(listings) * procs);
+        SharedArray<uint32_t> ids(N * procs);
+        SharedArray<ChildResult> results(procs);
+
+        std::vector<Body> bodies;
+        for (unsigned p = 0; p < procs; ++p) {
+            bodies.push_back([&, p](SharedRegistry& reg, ChildResult& r, Control&) {
+                std::vector<uint32_t> order(N);
+                for (uint32_t i = 0; i < N; ++i) order[i] = i;
+                std::shuffle(order.begin(), order.end(), std::mt19937(1000 + p));
+                uint32_t* mine = ids.data() + static_cast<std::size_t>(p) * N;
+                Timer<> t;
+                for (uint32_t i : order) mine[i] = reg.get_id(listings[i]);
+                r.ms = t.elapsed_ms();
+                r.count = N;
+            });
+        }
+        const bool ran = run_processes(name, bodies, results);
+        SharedRegistry::unlink(name);
+        if (!ran) {
+            std::cerr << "ERROR [agree processes=" << procs << "]: a child process failed\n";
+            return 1;
+        }
+
+        bool agree = true;
+        std::unordered_set<uint32_t> distinct;
+        for (std::size_t i = 0; agree && i < N; ++i) {
+            const uint32_t id = ids[i];
+            agree = registry.get_symbol(id) == listings[i] && distinct.insert(id).second;
+            for (unsigned p = 1; agree && p < procs; ++p) agree = ids[p * N + i] == id;
+        }
+        if (!agree) {
+            std::cerr << "ERROR [agree processes=" << procs << "]: processes disagree on ids\n";
+            return 1;
+        }
+        double slowest = 0;
+        for (unsigned p = 0; p < procs; ++p) slowest = std::max(slowest, results[p].ms);
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(PW) << procs
+                  << std::setw(CW) << static_cast<double>(N * procs) / (slowest * 1e3)
+                  << std::setw(CW) << registry.size()
+                  << std::setw(CW) << registry.size() - N << "\n";
+    }
+    std::cout << std::string(TOTAL, '-') << "\n";
+    return 0;
+}
+
+static int run_readers_scenario(std::size_t lookups, unsigned max_processes) {
+    const auto universe = generate_tickers(4096);
+    const auto stream = generate_stream(universe, lookups);
+
+    std::cout << "\n---> [readers] 4096 tickers listed; readers run " << lookups
+              << " get_id each, alone and next to 1 writer process\n";
+    const int PW = 12;
+    const int CW = 18;
+    const int TOTAL = PW + CW * 3;
+    std::cout << std::right << std::setw(PW) << "Readers" << std::setw(CW) << "alone (ns)"
+              << std::setw(CW) << "with writer (ns)" << std::setw(CW) << "writer M ins/s" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    uint64_t expected = 0;
+    {
+        LockedRegistry reference;
+        for (const auto& s : universe) reference.get_id(s);
+        for (const auto& s : stream) expected += reference.get_id(s);
+    }
+
+    for (unsigned readers = 1; readers <= std::max(1u, max_processes - 1); readers *= 2) {
+        double ns[2] = {0, 0};
+        double writer_rate = 0;
+        for (int with_writer = 0; with_writer < 2; ++with_writer) {
+            const std::string name = segment_name("readers");
+            SharedRegistry registry = SharedRegistry::create(
+                name, static_cast<uint32_t>(universe.size() + lookups), text_bytes(universe) + 16 * lookups);
+            for (const auto& s : universe) registry.get_id(s);
+            SharedArray<ChildResult> results(readers + 1);
+            SharedArray<std::atomic<unsigned>> done(1);
+
+            std::vector<Body> bodies;
+            for (unsigned r = 0; r < readers; ++r) {
+                bodies.push_back([&](SharedRegistry& reg, ChildResult& res, Control&) {
+                    Timer<> t;
+                    uint64_t sum = 0;
+                    for (const auto& s : stream) sum += reg.get_id(s);
+                    res.ms = t.elapsed_ms();
+                    res.count = stream.size();
+                    res.sum = sum;
+                    done[0].fetch_add(1, std::memory_order_release);
+                });
+            }
+            if (with_writer) {
+                bodies.push_back([&](SharedRegistry& reg, ChildResult& res, Control&) {
+                    char buf[32];
+                    Timer<> t;
+                    std::size_t i = 0;
+                    for (; i < lookups && done[0].load(std::memory_order_acquire) < readers; ++i) {
+                        const int n = std::snprintf(buf, sizeof(buf), "W%zu", i);
+                        reg.get_id(std::string_view(buf, static_cast<std::size_t>(n)));
+                    }
+                    res.ms = t.elapsed_ms();
+                    res.count = i;
+                });
+            }
+            const bool ran = run_processes(name, bodies, results);
+            SharedRegistry::unlink(name);
+            if (!ran) {
+                std::cerr << "ERROR [readers=" << readers << "]: a child process failed\n";
+                return 1;
+            }
+
+            bool ok = true;
+            double total_ms = 0;
+            for (unsigned r = 0; ok && r < readers; ++r) {
+                ok = results[r].sum == expected;
+                total_ms += results[r].ms;
+            }
+            if (!ok) {
+                std::cerr << "ERROR [readers=" << readers << "]: reader saw wrong ids\n";
+                return 1;
+            }
+            ns[with_writer] = total_ms * 1e6 / static_cast<double>(readers * lookups);
+            if (with_writer)
+                writer_rate = static_cast<double>(results[readers].count) / (results[readers].ms * 1e3);
+        }
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(PW) << readers << std::setw(CW) << ns[0]
+                  << std::setw(CW) << ns[1] << std::setw(CW) << writer_rate << "\n";
+    }
+    std::cout << std::string(TOTAL, '-') << "\n";
+    return 0;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t LOOKUPS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+    const unsigned MAX_PROCESSES =
+        argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                 : std::max(4u, std::thread::hardware_concurrency());
+
+    std::cout << "micrometrics - shared-memory symbol registry across processes\n"
+              << "Lookups    : " << LOOKUPS << " get_id per cell\n"
+              << "Processes  : 1 to " << MAX_PROCESSES << "\n";
+
+    try {
+        int rc = run_lookup_scenario(LOOKUPS);
+        if (rc == 0) rc = run_agree_scenario(LOOKUPS, MAX_PROCESSES);
+        if (rc == 0) rc = run_readers_scenario(LOOKUPS, MAX_PROCESSES);
+        std::cout << "\n";
+        return rc;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,343 @@
+/* micrometrics : Symbol Handles with pointer-identity equality
+ *
+ * With the 0001 registry, callers carry a uint32_t id for comparisons and
+ * a separate string_view (or a get_symbol call) for the text. Here the
+ * registry hands out a Symbol: one pointer to the symbol's interned entry,
+ *
+ *   SymbolEntry   hash (std::hash<std::string_view> of the text), id,
+ *                 length, then the text bytes; allocated once in an
+ *                 append-only arena and never moved or freed while the
+ *                 registry lives
+ *   Symbol        8 bytes, trivially copyable
+ *                   ==      pointer compare (one entry per distinct symbol)
+ *                   hash    load of the stored id: ids are dense, so
+ *                           unordered_map buckets fill evenly (the
+ *                           stored text hash is kept for the registry
+ *                           and any string-side lookups)
+ *                   str()   string_view over the entry, no lookup
+ *                   id()    load of the stored id, for id-indexed tables
+ *                 A default Symbol refers to a static empty entry (id NIL).
+ *
+ * The registry index is std::unordered_map<std::string_view, entry*>,
+ * keyed by views into the entries, so a lookup hashes the query once and
+ * allocates nothing.
+ *
+ * Scenario
+ *   Per-instrument position state (net quantity and fill count) updated by
+ *   a stream of `events` fills over universes of 45, 4096 and 100 000
+ *   symbols (the last 19-char option symbols, past the SSO buffer). Each
+ *   table holds every symbol before timing; the event carries the key its
+ *   table needs:
+ *     unordered_map<std::string, T>   event carries a std::string
+ *     unordered_map<Symbol, T>        event carries a Symbol
+ *     unordered_map<uint32_t, T>      event carries an id
+ *     std::vector<T> by id            event carries an id
+ *   Reported: ns per event. Every table must end with the same positions.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o 0013-symbol-handle 0013-symbol-handle.cpp
+ *
+ * Run:
+ *   ./0013-symbol-handle [events]
+ *   default: events=2 000 000 per cell
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+constexpr uint32_t NIL = UINT32_MAX;
+
+// ---------------------------------------------------------------------------
+// Interned entries and handles
+// ---------------------------------------------------------------------------
+struct SymbolEntry {
+    uint64_t hash;
+    uint32_t id;
+    uint32_t length;
+
+    // The text is stored right after the entry.
+    const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+    std::string_view str() const { return {data(), length}; }
+};
+
+class Symbol {
+private:
+    static const SymbolEntry EMPTY;
+    const SymbolEntry* entry_ = &EMPTY;
+
+    explicit Symbol(const SymbolEntry* entry) : entry_(entry) {}
+    friend class SymbolRegistry;
+
+public:
+    Symbol() = default;
+
+    std::string_view str()  const { return entry_->str(); }
+    uint32_t         id()   const { return entry_->id; }
+    uint64_t         hash() const { return entry_->hash; }
+    std::size_t      size() const { return entry_->length; }
+
+    friend bool operator==(Symbol a, Symbol b) { return a.entry_ == b.entry_; }
+    friend bool operator!=(Symbol a, Symbol b) { return a.entry_ != b.entry_; }
+};
+
+const SymbolEntry Symbol::EMPTY = {std::hash<std::string_view>{}(std::string_view()), NIL, 0};
+
+static_assert(sizeof(Symbol) == sizeof(void*), "Symbol must stay one pointer");
+static_assert(std::is_trivially_copyable<Symbol>::value, "Symbol must be trivially copyable");
+
+namespace std {
+template <>
+struct hash<Symbol> {
+    std::size_t operator()(Symbol s) const noexcept { return s.id(); }
+};
+}  // namespace std
+
+
+/* The 0001 registry API (get_id / get_symbol) plus intern() and symbol(id)
+ * returning handles. Entries live in CHUNK-byte arena blocks (a symbol too
+ * long for a block gets its own), so a handle stays valid as long as the
+ * registry. */
+class SymbolRegistry {
+private:
+    static constexpr std::size_t CHUNK = 64 * 1024;
+
+    std::unordered_map<std::string_view, const SymbolEntry*> index_;
+    std::vector<const SymbolEntry*>                          by_id_;
+    std::vector<std::unique_ptr<char[]>>                     chunks_;
+    char*                                                    chunk_      = nullptr;
+    std::size_t                                              chunk_used_ = CHUNK;
+    std::mutex                                               mtx;
+
+    const SymbolEntry* allocate(std::string_view symbol, uint64_t hash) {
+        const std::size_t bytes =
+            (sizeof(SymbolEntry) + symbol.size() + alignof(SymbolEntry) - 1) & ~(alignof(SymbolEntry) - 1);
+        char* at;
+        if (bytes > CHUNK) {
+            chunks_.emplace_back(new char[bytes]);
+            at = chunks_.back().get();
+        } else {
+            if (chunk_used_ + bytes > CHUNK) {
+                chunks_.emplace_back(new char[CHUNK]);
+                chunk_      = chunks_.back().get();
+                chunk_used_ = 0;
+            }
+            at = chunk_ + chunk_used_;
+            chunk_used_ += bytes;
+        }
+        auto* entry = new (at) SymbolEntry{hash, static_cast<uint32_t>(by_id_.size()),
+                                           static_cast<uint32_t>(symbol.size())};
+        std::memcpy(at + sizeof(SymbolEntry), symbol.data(), symbol.size());
+        return entry;
+    }
+
+public:
+    Symbol intern(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = index_.find(symbol);
+        if (it != index_.end()) return Symbol(it->second);
+
+        if (by_id_.size() >= NIL) throw std::length_error("SymbolRegistry: no free id");
+        const SymbolEntry* entry = allocate(symbol, std::hash<std::string_view>{}(symbol));
+        by_id_.push_back(entry);
+        index_.emplace(entry->str(), entry);
+        return Symbol(entry);
+    }
+
+    uint32_t get_id(std::string_view symbol) { return intern(symbol).id(); }
+
+    Symbol symbol(uint32_t id) const { return Symbol(by_id_.at(id)); }
+
+    inline std::string_view get_symbol(uint32_t id) const { return by_id_.at(id)->str(); }
+
+    std::size_t size() const { return by_id_.size(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+static const std::vector<std::string> SYMBOL_POOL = {
+    "AAPL", "MSFT", "GOOGL", "AMZN", "NVDA", "TSLA", "META", "BRK.B", "JPM",  "V",
+    "SPY",  "QQQ",  "IWM",   "DIA",  "GLD",  "TLT",  "VTI",  "EEM",   "XLF",  "HYG",
+    "EURUSD", "GBPUSD", "USDJPY", "USDCHF", "AUDUSD",
+    "NZDUSD", "USDCAD", "EURGBP", "EURJPY", "GBPJPY",
+    "ES",  "NQ",  "CL",  "GC",  "SI", "NG",  "ZB",  "ZN",  "ZC",  "ZS",
+    "BTCUSD", "ETHUSD", "SOLUSD", "BNBUSD", "XRPUSD",
+};
+
+static std::vector<std::string> generate_tickers(std::size_t n, unsigned seed = 7) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> length(3, 8);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> universe;
+    while (universe.size() < n) {
+        std::string s(static_cast<std::size_t>(length(rng)), ' ');
+        for (char& c : s) c = static_cast<char>(letter(rng));
+        if (seen.insert(s).second) universe.push_back(std::move(s));
+    }
+    return universe;
+}
+
+// OCC-style option symbols: 4-letter root, expiry, C/P, 8-digit strike.
+static std::vector<std::string> generate_options(std::size_t n) {
+    std::vector<std::string> universe;
+    universe.reserve(n);
+    char buf[32];
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t root = i / 2'000;
+        std::snprintf(buf, sizeof(buf), "%c%c%c%c26%02zu18%c%08zu",
+                      static_cast<char>('A' + root / 17'576 % 26), static_cast<char>('A' + root / 676 % 26),
+                      static_cast<char>('A' + root / 26 % 26), static_cast<char>('A' + root % 26),
+                      (i / 200) % 10 + 1, i % 2 ? 'P' : 'C', (i / 2 % 100 + 1) * 500);
+        universe.emplace_back(buf);
+    }
+    return universe;
+}
+
+struct Position {
+    int64_t  net   = 0;
+    uint64_t fills = 0;
+};
+
+template <typename Key>
+struct Fill {
+    Key     key;
+    int64_t quantity;
+};
+
+// Applies every fill to `book` (all keys present); returns ns per fill.
+template <typename Book, typename Key>
+static double apply_fills(Book& book, const std::vector<Fill<Key>>& fills) {
+    Timer<> t;
+    for (const Fill<Key>& f : fills) {
+        Position& p = book[f.key];
+        p.net += f.quantity;
+        ++p.fills;
+    }
+    return t.elapsed_ms() * 1e6 / static_cast<double>(fills.size());
+}
+
+// Order-independent digest of the positions, by symbol id.
+static uint64_t digest(const std::vector<Position>& by_id) {
+    uint64_t d = 0;
+    for (std::size_t i = 0; i < by_id.size(); ++i)
+        d += (i + 1) * (static_cast<uint64_t>(by_id[i].net) * 31 + by_id[i].fills);
+    return d;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t EVENTS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+
+    std::cout << "micrometrics - Symbol handles: pointer-identity keys vs strings and ids\n"
+              << "Events     : " << EVENTS << " fills per cell\n"
+              << "Key size   : Symbol " << sizeof(Symbol) << " B, std::string "
+              << sizeof(std::string) << " B, id " << sizeof(uint32_t) << " B\n";
+
+    const int UW = 16;
+    const int CW = 18;
+    const int TOTAL = UW + CW * 4;
+    std::cout << "\n---> position updates  (ns per fill)\n";
+    std::cout << std::left << std::setw(UW) << "Universe" << std::right
+              << std::setw(CW) << "map<string>" << std::setw(CW) << "map<Symbol>"
+              << std::setw(CW) << "map<uint32_t>" << std::setw(CW) << "vector[id]" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    struct Universe {
+        const char*              name;
+        std::vector<std::string> symbols;
+    };
+    for (const Universe& u : {Universe{"45 tickers", SYMBOL_POOL},
+                              Universe{"4096 tickers", generate_tickers(4096)},
+                              Universe{"100000 options", generate_options(100'000)}}) {
+        SymbolRegistry registry;
+        std::vector<Symbol> handles;
+        for (const auto& s : u.symbols) handles.push_back(registry.intern(s));
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<std::size_t> pick(0, u.symbols.size() - 1);
+        std::vector<Fill<std::string>> string_fills;
+        std::vector<Fill<Symbol>>      symbol_fills;
+        std::vector<Fill<uint32_t>>    id_fills;
+        string_fills.reserve(EVENTS);
+        symbol_fills.reserve(EVENTS);
+        id_fills.reserve(EVENTS);
+        for (std::size_t i = 0; i < EVENTS; ++i) {
+            const std::size_t k = pick(rng);
+            const int64_t quantity = static_cast<int64_t>(i % 7) - 3;
+            string_fills.push_back({u.symbols[k], quantity});
+            symbol_fills.push_back({handles[k], quantity});
+            id_fills.push_back({handles[k].id(), quantity});
+        }
+
+        std::unordered_map<std::string, Position> by_string;
+        std::unordered_map<Symbol, Position>      by_symbol;
+        std::unordered_map<uint32_t, Position>    by_map_id;
+        std::vector<Position>                     by_id(registry.size());
+        for (Symbol s : handles) {
+            by_string[std::string(s.str())];
+            by_symbol[s];
+            by_map_id[s.id()];
+        }
+
+        const double ns_string = apply_fills(by_string, string_fills);
+        const double ns_symbol = apply_fills(by_symbol, symbol_fills);
+        const double ns_map_id = apply_fills(by_map_id, id_fills);
+        const double ns_vector = apply_fills(by_id, id_fills);
+
+        std::vector<Position> from_string(registry.size()), from_symbol(registry.size()),
+                              from_map_id(registry.size());
+        for (const auto& [key, p] : by_string) from_string[registry.get_id(key)] = p;
+        for (const auto& [key, p] : by_symbol) from_symbol[key.id()] = p;
+        for (const auto& [key, p] : by_map_id) from_map_id[key] = p;
+        const uint64_t d = digest(by_id);
+        if (digest(from_string) != d || digest(from_symbol) != d || digest(from_map_id) != d
+                || registry.symbol(handles.back().id()) != handles.back()
+                || registry.intern(u.symbols.front()) != handles.front()) {
+            std::cerr << "ERROR [" << u.name << "]: tables disagree on positions\n";
+            return 1;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::left << std::setw(UW) << u.name << std::right
+                  << std::setw(CW) << ns_string << std::setw(CW) << ns_symbol
+                  << std::setw(CW) << ns_map_id << std::setw(CW) << ns_vector << "\n";
+    }
+    std::cout << std::string(TOTAL, '-') << "\n\n";
+    return 0;
+}
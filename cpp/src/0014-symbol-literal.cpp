@@ -0,0 +1,369 @@
+/* micrometrics : Compile-time Symbol Literals
+ *
+ * Strategy code with hard-coded instruments tends to read
+ *
+ *   const std::string target = "BTCUSD";
+ *   ...
+ *   if (md.id == registry.get_id(target)) ...
+ *
+ * which builds (or copies), hashes and compares the target text on every
+ * event. Here "BTCUSD"_sym is a constexpr SymbolLiteral: the packed 16-byte
+ * key and its hash are computed by the compiler, and the registry binds it
+ * to an id by probing with that precomputed hash (no hashing at run time).
+ *
+ *   SymbolLiteral    Key16 (zero-padded text, as in 0010) + hash_key of it +
+ *                    a view of the text; "..."_sym is a constexpr literal
+ *                    operator, so `constexpr auto BTC = "BTCUSD"_sym;`
+ *                    forces compile-time evaluation and a symbol over 16
+ *                    chars or containing NUL fails to compile
+ *   SymbolRegistry   flat open addressing over Key16 (0010 flat hash);
+ *                    get_id(std::string_view) packs and hashes the query,
+ *                    get_id(SymbolLiteral) only probes; both insert on miss
+ *
+ * C++17 does not allow class-type (fixed-string) non-type template
+ * parameters, and the string literal operator template that would carry
+ * the characters as a template<char...> pack is a GNU extension rejected
+ * by -Wpedantic, so the literal is a value rather than a type: bind it
+ * once at start-up (`const uint32_t btc = registry.get_id(BTC);`) and
+ * match on the id.
+ *
+ * Scenario
+ *   A market-data stream of `events` symbol ids drawn uniformly from the
+ *   universe (45 tickers, or 4096 tickers plus those 45); a strategy
+ *   counts the events for 1 or 8 hard-coded targets. Matchers:
+ *     0001 get_id      std::string targets, get_id on the 0001 registry
+ *                      (unordered_map + mutex) per event and target
+ *     get_id(string)   std::string targets, runtime pack + hash + probe on
+ *                      SymbolRegistry per event and target
+ *     get_id(_sym)     SymbolLiteral targets, probe only, per event and
+ *                      target
+ *     bound id         SymbolLiteral targets bound to ids at start-up; an
+ *                      id compare per event and target
+ *   Reported: ns per event. Every matcher must count the same events.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o 0014-symbol-literal 0014-symbol-literal.cpp
+ *
+ * Run:
+ *   ./0014-symbol-literal [events]
+ *   default: events=2 000 000 per cell
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------
+// Packed keys
+// ---------------------------------------------------------------------------
+constexpr uint32_t NIL = UINT32_MAX;
+
+struct Key16 {
+    uint64_t lo;
+    uint64_t hi;
+    constexpr bool operator==(const Key16& o) const { return lo == o.lo && hi == o.hi; }
+};
+
+/* Zero-padded little-endian packing of up to 16 chars, written with shifts
+ * so the same function runs in constant evaluation and at run time. */
+constexpr Key16 pack_key(std::string_view symbol) {
+    if (symbol.size() > 16) throw std::length_error("symbol wider than the packed key");
+    Key16 key{0, 0};
+    for (std::size_t i = 0; i < symbol.size(); ++i) {
+        if (symbol[i] == '\0') throw std::invalid_argument("symbol contains NUL");
+        const uint64_t byte = static_cast<unsigned char>(symbol[i]);
+        if (i < 8) key.lo |= byte << (8 * i);
+        else       key.hi |= byte << (8 * (i - 8));
+    }
+    return key;
+}
+
+constexpr std::size_t hash_key(const Key16& k) {
+    const uint64_t h = (k.lo ^ (k.hi * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
+struct SymbolLiteral {
+    Key16            key;
+    std::size_t      hash;
+    std::string_view text;
+};
+
+constexpr SymbolLiteral operator""_sym(const char* s, std::size_t n) {
+    const Key16 key = pack_key(std::string_view(s, n));
+    return {key, hash_key(key), std::string_view(s, n)};
+}
+
+
+// ---------------------------------------------------------------------------
+// Registries
+// ---------------------------------------------------------------------------
+/* Open addressing over packed 16-byte keys; power-of-two table, linear
+ * probing, grows at half full. A SymbolLiteral brings its own key and
+ * hash, so looking one up is the probe alone. */
+class SymbolRegistry {
+private:
+    struct Slot {
+        Key16    key;
+        uint32_t id = NIL;
+    };
+
+    std::vector<Slot>        slots_ = std::vector<Slot>(16);
+    std::vector<std::string> names_;
+
+    void rehash() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        const std::size_t mask = slots_.size() - 1;
+        for (const Slot& s : old) {
+            if (s.id == NIL) continue;
+            std::size_t i = hash_key(s.key) & mask;
+            while (slots_[i].id != NIL) i = (i + 1) & mask;
+            slots_[i] = s;
+        }
+    }
+
+    uint32_t find_or_insert(const Key16& key, std::size_t hash, std::string_view symbol) {
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = hash & mask;
+        for (; slots_[i].id != NIL; i = (i + 1) & mask)
+            if (slots_[i].key == key) return slots_[i].id;
+
+        if ((names_.size() + 1) * 2 > slots_.size()) {
+            rehash();
+            mask = slots_.size() - 1;
+            for (i = hash & mask; slots_[i].id != NIL; i = (i + 1) & mask) {}
+        }
+        const uint32_t id = static_cast<uint32_t>(names_.size());
+        slots_[i] = {key, id};
+        names_.emplace_back(symbol);
+        return id;
+    }
+
+public:
+    uint32_t get_id(std::string_view symbol) {
+        const Key16 key = pack_key(symbol);
+        return find_or_insert(key, hash_key(key), symbol);
+    }
+
+    uint32_t get_id(const SymbolLiteral& symbol) {
+        return find_or_insert(symbol.key, symbol.hash, symbol.text);
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return names_.at(id); }
+    std::size_t size() const { return names_.size(); }
+};
+
+// The 0001 SymbolRegistry: unordered_map behind a mutex.
+class LockedRegistry {
+private:
+    std::unordered_map<std::string, uint32_t> string_to_id_;
+    std::vector<std::string>                  id_to_string_;
+    std::mutex                                mtx;
+
+public:
+    uint32_t get_id(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string key(symbol);
+        auto it = string_to_id_.find(key);
+        if (it != string_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
+        string_to_id_[key] = new_id;
+        id_to_string_.emplace_back(symbol);
+        return new_id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return id_to_string_.at(id); }
+    std::size_t size() const { return id_to_string_.size(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Targets
+// ---------------------------------------------------------------------------
+constexpr std::size_t MAX_TARGETS = 8;
+
+constexpr std::array<SymbolLiteral, MAX_TARGETS> TARGET_LITERALS = {
+    "BTCUSD"_sym, "ETHUSD"_sym, "EURUSD"_sym, "USDJPY"_sym,
+    "ES"_sym,     "SPY"_sym,    "AAPL"_sym,   "NVDA"_sym,
+};
+
+static_assert(TARGET_LITERALS[0].hash == hash_key(pack_key("BTCUSD")),
+              "_sym must hash at compile time");
+static_assert(pack_key("ES").hi == 0 && pack_key("ES").lo == 0x5345,
+              "keys are little-endian and zero padded");
+
+static const std::array<std::string, MAX_TARGETS> TARGET_STRINGS = {
+    "BTCUSD", "ETHUSD", "EURUSD", "USDJPY", "ES", "SPY", "AAPL", "NVDA",
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+static const std::vector<std::string> SYMBOL_POOL = {
+    "AAPL", "MSFT", "GOOGL", "AMZN", "NVDA", "TSLA", "META", "BRK.B", "JPM",  "V",
+    "SPY",  "QQQ",  "IWM",   "DIA",  "GLD",  "TLT",  "VTI",  "EEM",   "XLF",  "HYG",
+    "EURUSD", "GBPUSD", "USDJPY", "USDCHF", "AUDUSD",
+    "NZDUSD", "USDCAD", "EURGBP", "EURJPY", "GBPJPY",
+    "ES",  "NQ",  "CL",  "GC",  "SI", "NG",  "ZB",  "ZN",  "ZC",  "ZS",
+    "BTCUSD", "ETHUSD", "SOLUSD", "BNBUSD", "XRPUSD",
+};
+
+static std::vector<std::string> generate_tickers(std::size_t n, unsigned seed = 7) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> length(3, 8);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::unordered_set<std::string> seen(SYMBOL_POOL.begin(), SYMBOL_POOL.end());
+    std::vector<std::string> universe;
+    while (universe.size() < n) {
+        std::string s(static_cast<std::size_t>(length(rng)), ' ');
+        for (char& c : s) c = static_cast<char>(letter(rng));
+        if (seen.insert(s).second) universe.push_back(std::move(s));
+    }
+    return universe;
+}
+
+using Counts = std::array<uint64_t, MAX_TARGETS>;
+
+struct LockedGetId {
+    static constexpr const char* name = "0001 get_id";
+    LockedRegistry& registry;
+    void match(const std::vector<uint32_t>& events, std::size_t targets, Counts& counts) {
+        for (uint32_t id : events)
+            for (std::size_t t = 0; t < targets; ++t)
+                counts[t] += id == registry.get_id(TARGET_STRINGS[t]);
+    }
+};
+
+struct StringGetId {
+    static constexpr const char* name = "get_id(string)";
+    SymbolRegistry& registry;
+    void match(const std::vector<uint32_t>& events, std::size_t targets, Counts& counts) {
+        for (uint32_t id : events)
+            for (std::size_t t = 0; t < targets; ++t)
+                counts[t] += id == registry.get_id(TARGET_STRINGS[t]);
+    }
+};
+
+struct LiteralGetId {
+    static constexpr const char* name = "get_id(_sym)";
+    SymbolRegistry& registry;
+    void match(const std::vector<uint32_t>& events, std::size_t targets, Counts& counts) {
+        for (uint32_t id : events)
+            for (std::size_t t = 0; t < targets; ++t)
+                counts[t] += id == registry.get_id(TARGET_LITERALS[t]);
+    }
+};
+
+struct BoundId {
+    static constexpr const char* name = "bound id";
+    SymbolRegistry& registry;
+    void match(const std::vector<uint32_t>& events, std::size_t targets, Counts& counts) {
+        std::array<uint32_t, MAX_TARGETS> bound{};
+        for (std::size_t t = 0; t < targets; ++t) bound[t] = registry.get_id(TARGET_LITERALS[t]);
+        for (uint32_t id : events)
+            for (std::size_t t = 0; t < targets; ++t)
+                counts[t] += id == bound[t];
+    }
+};
+
+// ns per event; `counts` receives the matches per target.
+template <typename Matcher>
+static double measure(Matcher matcher, const std::vector<uint32_t>& events,
+                      std::size_t targets, Counts& counts) {
+    counts.fill(0);
+    Timer<> t;
+    matcher.match(events, targets, counts);
+    return t.elapsed_ms() * 1e6 / static_cast<double>(events.size());
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t EVENTS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+
+    std::cout << "micrometrics - compile-time symbol literals vs runtime get_id\n"
+              << "Events     : " << EVENTS << " market-data events per cell\n"
+              << "Targets    : 1 or " << MAX_TARGETS << " hard-coded instruments\n";
+
+    const int UW = 16;
+    const int TW = 9;
+    const int CW = 16;
+    const int TOTAL = UW + TW + CW * 4;
+    std::cout << "\n---> constant-target matching  (ns per event)\n";
+    std::cout << std::left << std::setw(UW) << "Universe" << std::right << std::setw(TW) << "Targets"
+              << std::setw(CW) << LockedGetId::name << std::setw(CW) << StringGetId::name
+              << std::setw(CW) << LiteralGetId::name << std::setw(CW) << BoundId::name << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    std::vector<std::string> wide = SYMBOL_POOL;
+    for (auto& s : generate_tickers(4096)) wide.push_back(std::move(s));
+
+    struct Universe {
+        const char*              name;
+        std::vector<std::string> symbols;
+    };
+    for (const Universe& u : {Universe{"45 tickers", SYMBOL_POOL},
+                              Universe{"4141 tickers", wide}}) {
+        LockedRegistry locked;
+        SymbolRegistry registry;
+        for (const auto& s : u.symbols) {
+            locked.get_id(s);
+            registry.get_id(s);
+        }
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(u.symbols.size() - 1));
+        std::vector<uint32_t> events(EVENTS);
+        for (uint32_t& id : events) id = pick(rng);
+
+        for (std::size_t targets : {std::size_t{1}, MAX_TARGETS}) {
+            Counts c_locked, c_string, c_literal, c_bound;
+            const double ns_locked  = measure(LockedGetId{locked}, events, targets, c_locked);
+            const double ns_string  = measure(StringGetId{registry}, events, targets, c_string);
+            const double ns_literal = measure(LiteralGetId{registry}, events, targets, c_literal);
+            const double ns_bound   = measure(BoundId{registry}, events, targets, c_bound);
+            if (c_locked != c_string || c_string != c_literal || c_literal != c_bound
+                    || registry.size() != u.symbols.size()) {
+                std::cerr << "ERROR [" << u.name << ", " << targets
+                          << " targets]: matchers disagree on the matched events\n";
+                return 1;
+            }
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::left << std::setw(UW) << u.name << std::right << std::setw(TW) << targets
+                      << std::setw(CW) << ns_locked << std::setw(CW) << ns_string
+                      << std::setw(CW) << ns_literal << std::setw(CW) << ns_bound << "\n";
+        }
+    }
+    std::cout << std::string(TOTAL, '-') << "\n\n";
+    return 0;
+}
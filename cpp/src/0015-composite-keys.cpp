@@ -0,0 +1,336 @@
+/* micrometrics : Composite Instrument Keys - Interner<Key> vs formatted strings
+ *
+ * An option is (underlying, expiry, strike, right), yet the 0001 registry
+ * only interns strings, so callers format the fields into an OCC symbol
+ * ("AAPL  261218C00150000") just to call get_id. Interner<Key, Hash, Eq>
+ * is the 0001 registry (unordered_map + id vector behind a mutex) over any
+ * key type:
+ *
+ *   Hash  InternHash<Key> by default:
+ *           - std::hash<Key> when it is enabled (strings, integers, ...)
+ *           - std::tuple / std::pair: element hashes combined in order
+ *           - other trivially copyable types without padding bytes
+ *             (std::has_unique_object_representations): the object bytes,
+ *             8 at a time
+ *   Eq    InternEq<Key> by default: memcmp for the byte-hashed types (a
+ *         C++17 struct has no defaulted ==), std::equal_to otherwise
+ *
+ * Keys are stored once more in a std::deque, so get(id) references stay
+ * valid while the interner grows.
+ *
+ * Scenario
+ *   Option chains of `roots` underlyings x 8 expiries x 50 strikes x call
+ *   and put (default 100 roots: 80 000 contracts, plus an 800-contract
+ *   single-root chain). Underlyings are interned strings; a contract key
+ *   holds the underlying id. Forms compared:
+ *     format + string  OCC string formatted from the fields, then interned
+ *     string           the same strings, formatted before timing
+ *     struct           OptionKey {underlying, expiry, strike, right}
+ *     tuple            std::tuple<uint32_t, uint32_t, uint32_t, char>
+ *   build  : a fresh interner takes every contract once (ns per insert)
+ *   lookup : `lookups` get_id over random contracts (ns per get_id)
+ *   Every form must assign every contract the same id.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o 0015-composite-keys 0015-composite-keys.cpp
+ *
+ * Run:
+ *   ./0015-composite-keys [lookups] [roots]
+ *   default: lookups=2 000 000, roots=100
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+// ---------------------------------------------------------------------------
+// Hash and equality
+// ---------------------------------------------------------------------------
+static inline std::size_t hash_combine(std::size_t seed, std::size_t h) {
+    return seed ^ (h + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+}
+
+template <typename Key, typename = void>
+struct has_std_hash : std::false_type {};
+
+template <typename Key>
+struct has_std_hash<Key, std::void_t<decltype(std::hash<Key>{}(std::declval<const Key&>()))>>
+    : std::true_type {};
+
+// Keys hashed and compared as raw bytes: no std::hash, no padding.
+template <typename Key>
+constexpr bool byte_key_v = !has_std_hash<Key>::value
+                            && std::is_trivially_copyable_v<Key>
+                            && std::has_unique_object_representations_v<Key>;
+
+template <typename Key, typename = void>
+struct InternHash {
+    static_assert(byte_key_v<Key>,
+                  "InternHash: Key needs std::hash, or must be a tuple/pair, or trivially "
+                  "copyable without padding bytes");
+    std::size_t operator()(const Key& key) const noexcept {
+        unsigned char bytes[sizeof(Key)];
+        std::memcpy(bytes, &key, sizeof(Key));
+        uint64_t h = sizeof(Key);
+        std::size_t i = 0;
+        for (; i + 8 <= sizeof(Key); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+        if (i < sizeof(Key)) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i, sizeof(Key) - i);
+            h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+        return static_cast<std::size_t>(h);
+    }
+};
+
+template <typename Key>
+struct InternHash<Key, std::enable_if_t<has_std_hash<Key>::value>> : std::hash<Key> {};
+
+template <typename... Ts>
+struct InternHash<std::tuple<Ts...>> {
+    std::size_t operator()(const std::tuple<Ts...>& key) const noexcept {
+        return std::apply([](const Ts&... field) {
+            std::size_t seed = 0;
+            ((seed = hash_combine(seed, InternHash<Ts>{}(field))), ...);
+            return seed;
+        }, key);
+    }
+};
+
+template <typename A, typename B>
+struct InternHash<std::pair<A, B>> {
+    std::size_t operator()(const std::pair<A, B>& key) const noexcept {
+        return hash_combine(InternHash<A>{}(key.first), InternHash<B>{}(key.second));
+    }
+};
+
+template <typename Key, typename = void>
+struct InternEq : std::equal_to<Key> {};
+
+template <typename Key>
+struct InternEq<Key, std::enable_if_t<byte_key_v<Key>>> {
+    bool operator()(const Key& a, const Key& b) const noexcept {
+        return std::memcmp(&a, &b, sizeof(Key)) == 0;
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+// Interner
+// ---------------------------------------------------------------------------
+constexpr uint32_t NIL = UINT32_MAX;
+
+/* The 0001 SymbolRegistry generalized over the key: get_id interns on
+ * miss, ids are dense from 0 in first-seen order. */
+template <typename Key, typename Hash = InternHash<Key>, typename Eq = InternEq<Key>>
+class Interner {
+private:
+    std::unordered_map<Key, uint32_t, Hash, Eq> key_to_id_;
+    std::deque<Key>                             id_to_key_;
+    std::mutex                                  mtx;
+
+public:
+    uint32_t get_id(const Key& key) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = key_to_id_.find(key);
+        if (it != key_to_id_.end()) return it->second;
+
+        if (id_to_key_.size() >= NIL) throw std::length_error("Interner: no free id");
+        uint32_t new_id = static_cast<uint32_t>(id_to_key_.size());
+        key_to_id_.emplace(key, new_id);
+        id_to_key_.push_back(key);
+        return new_id;
+    }
+
+    const Key& get(uint32_t id) const { return id_to_key_.at(id); }
+    std::size_t size() const { return id_to_key_.size(); }
+};
+
+using SymbolRegistry = Interner<std::string>;
+
+
+// ---------------------------------------------------------------------------
+// Option keys
+// ---------------------------------------------------------------------------
+struct OptionKey {
+    uint32_t underlying;     // SymbolRegistry id of the root
+    uint32_t expiry;         // yymmdd
+    uint32_t strike_milli;   // strike x 1000
+    char     right;          // 'C' or 'P'
+    char     reserved[3];    // zero: keeps the key free of padding bytes
+};
+
+static_assert(sizeof(OptionKey) == 16, "OptionKey must stay 16 bytes");
+static_assert(byte_key_v<OptionKey>, "OptionKey must hash as raw bytes");
+
+using OptionTuple = std::tuple<uint32_t, uint32_t, uint32_t, char>;
+
+static OptionTuple as_tuple(const OptionKey& k) {
+    return {k.underlying, k.expiry, k.strike_milli, k.right};
+}
+
+// OCC symbol: root padded to 6, yymmdd, C/P, strike x 1000 in 8 digits.
+static std::string format_occ(const SymbolRegistry& roots, const OptionKey& k) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%-6s%06u%c%08u", roots.get(k.underlying).c_str(),
+                  k.expiry, k.right, k.strike_milli);
+    return buf;
+}
+
+static std::vector<OptionKey> make_chain(SymbolRegistry& roots, std::size_t n_roots) {
+    std::vector<OptionKey> chain;
+    chain.reserve(n_roots * 8 * 50 * 2);
+    for (std::size_t r = 0; r < n_roots; ++r) {
+        const char root[5] = {static_cast<char>('A' + r / 676 % 26), static_cast<char>('A' + r / 26 % 26),
+                              static_cast<char>('A' + r % 26), 'X', '\0'};
+        const uint32_t underlying = roots.get_id(root);
+        for (uint32_t month = 1; month <= 8; ++month)
+            for (uint32_t s = 0; s < 50; ++s)
+                for (char right : {'C', 'P'}) {
+                    OptionKey k{};
+                    k.underlying   = underlying;
+                    k.expiry       = 260018 + month * 100;
+                    k.strike_milli = (50 + 5 * s) * 1000;
+                    k.right        = right;
+                    chain.push_back(k);
+                }
+    }
+    return chain;
+}
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+// ns per get_id over `keys`, converting each with `to_key`; ids in `ids`.
+template <typename Interner, typename Source, typename ToKey>
+static double run(Interner& interner, const std::vector<Source>& keys, ToKey to_key,
+                  std::vector<uint32_t>& ids) {
+    ids.resize(keys.size());
+    Timer<> t;
+    for (std::size_t i = 0; i < keys.size(); ++i) ids[i] = interner.get_id(to_key(keys[i]));
+    return t.elapsed_ms() * 1e6 / static_cast<double>(keys.size());
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t LOOKUPS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+    const std::size_t ROOTS =
+        argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 100;
+
+    std::cout << "micrometrics - composite instrument keys: Interner<Key> vs formatted strings\n"
+              << "Lookups    : " << LOOKUPS << " get_id per cell\n"
+              << "Key size   : OptionKey " << sizeof(OptionKey) << " B, tuple "
+              << sizeof(OptionTuple) << " B, std::string " << sizeof(std::string)
+              << " B + heap (21-char OCC symbol)\n";
+
+    const int RW = 24;
+    const int CW = 18;
+    const int TOTAL = RW + CW * 4;
+    std::cout << "\n---> option chains  (ns per get_id)\n";
+    std::cout << std::left << std::setw(RW) << "Chain" << std::right
+              << std::setw(CW) << "format + string" << std::setw(CW) << "string"
+              << std::setw(CW) << "struct" << std::setw(CW) << "tuple" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    for (std::size_t n_roots : {std::size_t{1}, ROOTS}) {
+        SymbolRegistry roots;
+        const std::vector<OptionKey> chain = make_chain(roots, n_roots);
+        std::vector<std::string> occ;
+        occ.reserve(chain.size());
+        for (const OptionKey& k : chain) occ.push_back(format_occ(roots, k));
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<std::size_t> pick(0, chain.size() - 1);
+        std::vector<std::size_t> order(LOOKUPS);
+        for (std::size_t& i : order) i = pick(rng);
+        std::vector<OptionKey>   key_stream;
+        std::vector<std::string> occ_stream;
+        key_stream.reserve(LOOKUPS);
+        occ_stream.reserve(LOOKUPS);
+        for (std::size_t i : order) {
+            key_stream.push_back(chain[i]);
+            occ_stream.push_back(occ[i]);
+        }
+
+        Interner<std::string> fmt_interner, str_interner;
+        Interner<OptionKey>   key_interner;
+        Interner<OptionTuple> tup_interner;
+        std::vector<uint32_t> build_ids[4], lookup_ids[4];
+        const auto formatted = [&](const OptionKey& k) { return format_occ(roots, k); };
+        const auto same      = [](const auto& k) -> const auto& { return k; };
+
+        const double build[4] = {
+            run(fmt_interner, chain, formatted, build_ids[0]),
+            run(str_interner, occ, same, build_ids[1]),
+            run(key_interner, chain, same, build_ids[2]),
+            run(tup_interner, chain, as_tuple, build_ids[3]),
+        };
+        const double lookup[4] = {
+            run(fmt_interner, key_stream, formatted, lookup_ids[0]),
+            run(str_interner, occ_stream, same, lookup_ids[1]),
+            run(key_interner, key_stream, same, lookup_ids[2]),
+            run(tup_interner, key_stream, as_tuple, lookup_ids[3]),
+        };
+
+        for (int f = 1; f < 4; ++f)
+            if (build_ids[f] != build_ids[0] || lookup_ids[f] != lookup_ids[0]) {
+                std::cerr << "ERROR [" << chain.size() << " contracts]: forms assign different ids\n";
+                return 1;
+            }
+        if (key_interner.size() != chain.size()
+                || format_occ(roots, key_interner.get(lookup_ids[2].back()))
+                   != str_interner.get(lookup_ids[1].back())) {
+            std::cerr << "ERROR [" << chain.size() << " contracts]: get(id) disagrees\n";
+            return 1;
+        }
+
+        const std::string label = std::to_string(chain.size()) + " contracts";
+        for (const auto& [phase, ns] : {std::make_pair("build ", build), std::make_pair("lookup", lookup)}) {
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::left << std::setw(RW) << (label + " " + phase) << std::right;
+            for (int f = 0; f < 4; ++f) std::cout << std::setw(CW) << ns[f];
+            std::cout << "\n";
+        }
+    }
+    std::cout << std::string(TOTAL, '-') << "\n\n";
+    return 0;
+}
@@ -0,0 +1,372 @@
+/* micrometrics : Multi-venue Symbology - per-venue tables vs concatenated keys
+ *
+ * The same instrument is "AAPL" on one venue, "AAPL.O" on another and
+ * "AAPL US" on a third. SymbologyMap resolves (venue id, local symbol)
+ * aliases to one global instrument id in two levels:
+ *
+ *   instruments   canonical name -> dense global id, as in the 0001
+ *                 registry (get_id interns on miss)
+ *   VenueTable    one per venue, indexed by venue id: open addressing
+ *                 (power of two, linear probing, load <= 1/2) over 16-byte
+ *                 slots {hash tag, global id, text offset, length}; the
+ *                 local symbols live in one append-only text arena per
+ *                 venue. resolve() hashes the local symbol once, compares
+ *                 the tag and length before touching the text, and never
+ *                 allocates. Each table also keeps global id -> local
+ *                 symbol for the outbound direction.
+ *
+ * Aliases are added at start-up; resolve() and local() are const and may
+ * run concurrently with each other, but not with add_alias().
+ *
+ * Baselines
+ *   concat key       one std::unordered_map<std::string, uint32_t> keyed by
+ *                    "<venue>|<local>"; each lookup builds the key
+ *   concat prebuilt  the same map, keys built before timing (the feed
+ *                    would have to deliver them concatenated)
+ *   venue maps       std::vector of per-venue std::unordered_map<std::string,
+ *                    uint32_t>; each lookup builds a std::string key
+ *
+ * Scenario
+ *   `venues` venues x `symbols` instruments (default 10 x 100 000), each
+ *   venue listing every instrument under its own convention (plain, ".O",
+ *   " US", ":XNAS", ...). Build: every alias added once (ns per alias).
+ *   Resolve: `lookups` (venue, local symbol) pairs drawn uniformly (ns per
+ *   lookup). Every resolver must return the same global ids.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -o 0016-venue-symbology 0016-venue-symbology.cpp
+ *
+ * Run:
+ *   ./0016-venue-symbology [lookups] [symbols] [venues]
+ *   default: lookups=2 000 000, symbols=100 000, venues=10 (at most 10)
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+constexpr uint32_t NIL = UINT32_MAX;
+
+// ---------------------------------------------------------------------------
+// Symbology map
+// ---------------------------------------------------------------------------
+/* One venue's local symbol -> global id table. Slots hold the upper 32
+ * bits of the hash as a tag; an empty slot has global == NIL. */
+class VenueTable {
+private:
+    struct Slot {
+        uint32_t tag    = 0;
+        uint32_t global = NIL;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    std::vector<Slot>     slots_ = std::vector<Slot>(16);
+    std::string           text_;
+    std::vector<uint32_t> by_global_;   // slot index per global id, NIL if unlisted
+    std::size_t           size_ = 0;
+
+    static std::size_t hash(std::string_view local) { return std::hash<std::string_view>{}(local); }
+    static uint32_t tag_of(std::size_t h) { return static_cast<uint32_t>(static_cast<uint64_t>(h) >> 32); }
+
+    std::string_view text(const Slot& s) const { return {text_.data() + s.offset, s.length}; }
+
+    void rehash() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        const std::size_t mask = slots_.size() - 1;
+        for (const Slot& s : old) {
+            if (s.global == NIL) continue;
+            std::size_t i = hash(text(s)) & mask;
+            while (slots_[i].global != NIL) i = (i + 1) & mask;
+            slots_[i] = s;
+            by_global_[s.global] = static_cast<uint32_t>(i);
+        }
+    }
+
+    std::size_t find_slot(std::string_view local, std::size_t h) const {
+        const std::size_t mask = slots_.size() - 1;
+        const uint32_t tag = tag_of(h);
+        std::size_t i = h & mask;
+        for (; slots_[i].global != NIL; i = (i + 1) & mask) {
+            const Slot& s = slots_[i];
+            if (s.tag == tag && s.length == local.size()
+                    && std::memcmp(text_.data() + s.offset, local.data(), local.size()) == 0)
+                return i;
+        }
+        return i;
+    }
+
+public:
+    // false when `local` is already mapped (to `global` or to another id).
+    bool add(std::string_view local, uint32_t global) {
+        if (text_.size() + local.size() > UINT32_MAX) throw std::length_error("VenueTable: text arena full");
+        if ((size_ + 1) * 2 > slots_.size()) rehash();
+        const std::size_t h = hash(local);
+        const std::size_t i = find_slot(local, h);
+        if (slots_[i].global != NIL) return false;
+
+        slots_[i] = {tag_of(h), global, static_cast<uint32_t>(text_.size()),
+                     static_cast<uint32_t>(local.size())};
+        text_.append(local);
+        if (by_global_.size() <= global) by_global_.resize(global + 1, NIL);
+        by_global_[global] = static_cast<uint32_t>(i);
+        ++size_;
+        return true;
+    }
+
+    uint32_t resolve(std::string_view local) const {
+        return slots_[find_slot(local, hash(local))].global;
+    }
+
+    std::string_view local(uint32_t global) const {
+        if (global >= by_global_.size() || by_global_[global] == NIL) return {};
+        return text(slots_[by_global_[global]]);
+    }
+
+    std::size_t size() const { return size_; }
+};
+
+class SymbologyMap {
+private:
+    std::unordered_map<std::string, uint32_t> canonical_to_id_;
+    std::vector<std::string>                  id_to_canonical_;
+    std::vector<VenueTable>                   venues_;
+
+public:
+    uint32_t get_id(std::string_view canonical) {
+        std::string key(canonical);
+        auto it = canonical_to_id_.find(key);
+        if (it != canonical_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_canonical_.size());
+        canonical_to_id_.emplace(std::move(key), new_id);
+        id_to_canonical_.emplace_back(canonical);
+        return new_id;
+    }
+
+    bool add_alias(uint16_t venue, std::string_view local, uint32_t global) {
+        if (global >= id_to_canonical_.size()) throw std::out_of_range("SymbologyMap: unknown global id");
+        if (venues_.size() <= venue) venues_.resize(venue + 1u);
+        return venues_[venue].add(local, global);
+    }
+
+    // NIL for an unknown venue or an unlisted local symbol.
+    uint32_t resolve(uint16_t venue, std::string_view local) const {
+        return venue < venues_.size() ? venues_[venue].resolve(local) : NIL;
+    }
+
+    // The venue's local symbol for `global`, empty if it is not listed there.
+    std::string_view local(uint16_t venue, uint32_t global) const {
+        return venue < venues_.size() ? venues_[venue].local(global) : std::string_view();
+    }
+
+    std::string_view get_symbol(uint32_t global) const { return id_to_canonical_.at(global); }
+    std::size_t size() const { return id_to_canonical_.size(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Baselines
+// ---------------------------------------------------------------------------
+static std::string concat_key(uint16_t venue, std::string_view local) {
+    std::string key = std::to_string(venue);
+    key += '|';
+    key += local;
+    return key;
+}
+
+class ConcatMap {
+private:
+    std::unordered_map<std::string, uint32_t> map_;
+
+public:
+    bool add_alias(uint16_t venue, std::string_view local, uint32_t global) {
+        return map_.emplace(concat_key(venue, local), global).second;
+    }
+
+    uint32_t resolve(uint16_t venue, std::string_view local) const { return resolve(concat_key(venue, local)); }
+
+    uint32_t resolve(const std::string& key) const {
+        auto it = map_.find(key);
+        return it == map_.end() ? NIL : it->second;
+    }
+};
+
+class VenueMaps {
+private:
+    std::vector<std::unordered_map<std::string, uint32_t>> venues_;
+
+public:
+    bool add_alias(uint16_t venue, std::string_view local, uint32_t global) {
+        if (venues_.size() <= venue) venues_.resize(venue + 1u);
+        return venues_[venue].emplace(std::string(local), global).second;
+    }
+
+    uint32_t resolve(uint16_t venue, std::string_view local) const {
+        if (venue >= venues_.size()) return NIL;
+        auto it = venues_[venue].find(std::string(local));
+        return it == venues_[venue].end() ? NIL : it->second;
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+static std::vector<std::string> generate_tickers(std::size_t n, unsigned seed = 7) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> length(3, 8);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> universe;
+    while (universe.size() < n) {
+        std::string s(static_cast<std::size_t>(length(rng)), ' ');
+        for (char& c : s) c = static_cast<char>(letter(rng));
+        if (seen.insert(s).second) universe.push_back(std::move(s));
+    }
+    return universe;
+}
+
+constexpr std::size_t MAX_VENUES = 10;
+
+// Local symbol of `ticker` on venue `venue`.
+static std::string local_symbol(std::size_t venue, const std::string& ticker) {
+    static const char* const SUFFIX[MAX_VENUES] = {
+        "", ".O", " US", ":XNAS", "-EQ", ".N", "@ARCA", "_BATS", ".IEX", "/EDGX",
+    };
+    return ticker + SUFFIX[venue];
+}
+
+struct Alias {
+    uint16_t    venue;
+    std::string local;
+    uint32_t    global;
+};
+
+template <typename Map>
+static double build(Map& map, const std::vector<Alias>& aliases) {
+    Timer<> t;
+    for (const Alias& a : aliases)
+        if (!map.add_alias(a.venue, a.local, a.global)) throw std::logic_error("duplicate alias");
+    return t.elapsed_ms() * 1e6 / static_cast<double>(aliases.size());
+}
+
+// ns per lookup; resolved ids in `out`.
+template <typename Resolve>
+static double resolve_all(std::size_t n, Resolve resolve, std::vector<uint32_t>& out) {
+    out.resize(n);
+    Timer<> t;
+    for (std::size_t i = 0; i < n; ++i) out[i] = resolve(i);
+    return t.elapsed_ms() * 1e6 / static_cast<double>(n);
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t LOOKUPS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+    const std::size_t SYMBOLS =
+        argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 100'000;
+    const std::size_t VENUES =
+        std::min(MAX_VENUES, argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : MAX_VENUES);
+
+    std::cout << "micrometrics - multi-venue symbology: per-venue tables vs concatenated keys\n"
+              << "Venues     : " << VENUES << "\n"
+              << "Symbols    : " << SYMBOLS << " instruments, listed on every venue\n"
+              << "Lookups    : " << LOOKUPS << " (venue, local symbol) resolutions\n";
+
+    const std::vector<std::string> tickers = generate_tickers(SYMBOLS);
+    SymbologyMap symbology;
+    std::vector<Alias> aliases;
+    aliases.reserve(SYMBOLS * VENUES);
+    for (const std::string& t : tickers) symbology.get_id(t);
+    for (std::size_t v = 0; v < VENUES; ++v)
+        for (uint32_t g = 0; g < SYMBOLS; ++g)
+            aliases.push_back({static_cast<uint16_t>(v), local_symbol(v, tickers[g]), g});
+    std::shuffle(aliases.begin(), aliases.end(), std::mt19937(3));
+
+    ConcatMap concat;
+    VenueMaps venue_maps;
+    const double build_tables = build(symbology, aliases);
+    const double build_concat = build(concat, aliases);
+    const double build_maps   = build(venue_maps, aliases);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> pick(0, aliases.size() - 1);
+    std::vector<const Alias*> stream(LOOKUPS);
+    std::vector<std::string>  prebuilt(LOOKUPS);
+    for (std::size_t i = 0; i < LOOKUPS; ++i) {
+        stream[i]   = &aliases[pick(rng)];
+        prebuilt[i] = concat_key(stream[i]->venue, stream[i]->local);
+    }
+
+    std::vector<uint32_t> r_concat, r_prebuilt, r_maps, r_tables;
+    const double ns_concat = resolve_all(LOOKUPS, [&](std::size_t i) {
+        return concat.resolve(stream[i]->venue, stream[i]->local); }, r_concat);
+    const double ns_prebuilt = resolve_all(LOOKUPS, [&](std::size_t i) {
+        return concat.resolve(prebuilt[i]); }, r_prebuilt);
+    const double ns_maps = resolve_all(LOOKUPS, [&](std::size_t i) {
+        return venue_maps.resolve(stream[i]->venue, stream[i]->local); }, r_maps);
+    const double ns_tables = resolve_all(LOOKUPS, [&](std::size_t i) {
+        return symbology.resolve(stream[i]->venue, stream[i]->local); }, r_tables);
+
+    for (std::size_t i = 0; i < LOOKUPS; ++i)
+        if (r_tables[i] != stream[i]->global || r_concat[i] != r_tables[i]
+                || r_prebuilt[i] != r_tables[i] || r_maps[i] != r_tables[i]) {
+            std::cerr << "ERROR [lookup " << i << "]: resolvers disagree on ("
+                      << stream[i]->venue << ", " << stream[i]->local << ")\n";
+            return 1;
+        }
+    const Alias& last = aliases.back();
+    if (symbology.local(last.venue, last.global) != last.local
+            || symbology.resolve(last.venue, tickers[last.global] + "#") != NIL
+            || symbology.resolve(static_cast<uint16_t>(VENUES), last.local) != NIL) {
+        std::cerr << "ERROR: reverse mapping or unknown-alias lookup is wrong\n";
+        return 1;
+    }
+
+    const int RW = 18;
+    const int CW = 18;
+    const int TOTAL = RW + CW * 4;
+    std::cout << "\n---> alias resolution  (" << aliases.size() << " aliases, ns per alias / lookup)\n";
+    std::cout << std::left << std::setw(RW) << "Phase" << std::right
+              << std::setw(CW) << "concat key" << std::setw(CW) << "concat prebuilt"
+              << std::setw(CW) << "venue maps" << std::setw(CW) << "venue tables" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(2)
+              << std::left << std::setw(RW) << "build" << std::right
+              << std::setw(CW) << build_concat << std::setw(CW) << "-"
+              << std::setw(CW) << build_maps << std::setw(CW) << build_tables << "\n"
+              << std::left << std::setw(RW) << "resolve" << std::right
+              << std::setw(CW) << ns_concat << std::setw(CW) << ns_prebuilt
+              << std::setw(CW) << ns_maps << std::setw(CW) << ns_tables << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n\n";
+    return 0;
+}
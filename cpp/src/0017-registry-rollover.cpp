@@ -0,0 +1,557 @@
+/* micrometrics : Registry Rollover - versioned generations vs rebuild under lock
+ *
+ * At the session boundary the whole symbol universe is rebuilt. With the
+ * one locked 0001 SymbolRegistry, the rebuild either holds the lock (every
+ * lookup waits) or mutates the map under load. VersionedRegistry instead
+ * publishes immutable generations:
+ *
+ *   Generation        built off-thread from a symbol file (one symbol per
+ *                     line, ids in line order, duplicates keep the first
+ *                     id); open addressing sized once at load (power of
+ *                     two, load <= 1/2) over 16-byte slots {hash tag, id,
+ *                     text offset, length} and one text arena. Immutable,
+ *                     so lookups take no lock. get_id returns NIL for a
+ *                     symbol outside the generation: listings arrive with
+ *                     the next generation, not through lookups.
+ *   VersionedRegistry current generation behind an atomic pointer.
+ *                     publish() swaps in the next generation and retires
+ *                     the old one; reclaim() deletes every retired
+ *                     generation that no reader has pinned, drain() waits
+ *                     until all of them are gone.
+ *   Reader            one per reader thread; owns a cache-line-sized slot
+ *                     (READER_SLOTS per registry) where it publishes the
+ *                     generation it is using (a hazard pointer). pin()
+ *                     stores the current pointer to the slot and re-reads
+ *                     it until the two agree; unpin clears the slot. A
+ *                     Snapshot keeps one generation pinned across many
+ *                     calls, so ids and get_symbol views from it stay
+ *                     consistent; a reader holds one Snapshot at a time.
+ *
+ * Ids are per generation: a consumer keeping id-indexed state must check
+ * Snapshot::version() and remap on a change.
+ *
+ * Scenario
+ *   Day A lists `symbols` 19-char option symbols; day B drops the first
+ *   10% and lists as many new ones, both written to temporary symbol
+ *   files. `readers` threads each run `lookups` get_id over symbols listed
+ *   on both days, timing every call, while one writer rolls the registry
+ *   over between the two files every 10 ms until the readers finish:
+ *     0001 rebuild  the file is read outside the lock, then the maps are
+ *                   cleared and refilled under the registry mutex
+ *     versioned     Generation::load, publish(), drain()
+ *   Reported per backend: p50, p99, p99.99 and max ns per get_id outside
+ *   and during a rollover (from the start of the load until the old state
+ *   is gone), the rollover count and mean rollover ms.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -o 0017-registry-rollover 0017-registry-rollover.cpp
+ *
+ * Run:
+ *   ./0017-registry-rollover [lookups] [symbols] [readers]
+ *   default: lookups=2 000 000 per reader, symbols=100 000,
+ *            readers=std::thread::hardware_concurrency() - 1 (at least 1);
+ *            readers is capped at READER_SLOTS (64)
+ *
+ * Copyright (c) 2026, Augusto Damasceno. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * See (https://github.com/augustodamasceno/micrometrics)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+constexpr uint32_t NIL = UINT32_MAX;
+
+// ---------------------------------------------------------------------------
+// Generation
+// ---------------------------------------------------------------------------
+class Generation {
+private:
+    struct Slot {
+        uint32_t tag    = 0;
+        uint32_t id     = NIL;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    uint64_t          version_;
+    std::vector<Slot> slots_;
+    std::vector<Slot> by_id_;
+    std::string       text_;
+
+    static std::size_t hash(std::string_view symbol) { return std::hash<std::string_view>{}(symbol); }
+    static uint32_t tag_of(std::size_t h) { return static_cast<uint32_t>(static_cast<uint64_t>(h) >> 32); }
+
+    std::size_t find_slot(std::string_view symbol, std::size_t h) const {
+        const std::size_t mask = slots_.size() - 1;
+        const uint32_t tag = tag_of(h);
+        std::size_t i = h & mask;
+        for (; slots_[i].id != NIL; i = (i + 1) & mask) {
+            const Slot& s = slots_[i];
+            if (s.tag == tag && s.length == symbol.size()
+                    && std::memcmp(text_.data() + s.offset, symbol.data(), symbol.size()) == 0)
+                return i;
+        }
+        return i;
+    }
+
+    explicit Generation(uint64_t version) : version_(version) {}
+
+public:
+    static std::unique_ptr<Generation> load(const std::string& path, uint64_t version) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Generation: cannot open " + path);
+
+        std::unique_ptr<Generation> g(new Generation(version));
+        std::vector<Slot> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            if (g->text_.size() + line.size() > UINT32_MAX) throw std::length_error("Generation: text arena full");
+            lines.push_back({0, 0, static_cast<uint32_t>(g->text_.size()), static_cast<uint32_t>(line.size())});
+            g->text_ += line;
+        }
+        if (lines.size() >= NIL) throw std::length_error("Generation: no free id");
+
+        std::size_t capacity = 16;
+        while (capacity < lines.size() * 2) capacity *= 2;
+        g->slots_.resize(capacity);
+        g->by_id_.reserve(lines.size());
+        for (Slot s : lines) {
+            const std::string_view symbol(g->text_.data() + s.offset, s.length);
+            const std::size_t h = hash(symbol);
+            const std::size_t i = g->find_slot(symbol, h);
+            if (g->slots_[i].id != NIL) continue;
+            s.tag = tag_of(h);
+            s.id  = static_cast<uint32_t>(g->by_id_.size());
+            g->slots_[i] = s;
+            g->by_id_.push_back(s);
+        }
+        return g;
+    }
+
+    uint32_t get_id(std::string_view symbol) const {
+        return slots_[find_slot(symbol, hash(symbol))].id;
+    }
+
+    std::string_view get_symbol(uint32_t id) const {
+        const Slot& s = by_id_.at(id);
+        return {text_.data() + s.offset, s.length};
+    }
+
+    uint64_t version() const { return version_; }
+    std::size_t size() const { return by_id_.size(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Versioned registry
+// ---------------------------------------------------------------------------
+class VersionedRegistry {
+public:
+    static constexpr std::size_t READER_SLOTS = 64;
+
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<const Generation*> pinned{nullptr};
+        std::atomic<bool>              claimed{false};
+    };
+
+    std::atomic<const Generation*>                 current_;
+    std::unique_ptr<ReaderSlot[]>                  slots_;
+    std::mutex                                     writer_mtx_;
+    std::unique_ptr<const Generation>              live_;      // guarded by writer_mtx_
+    std::vector<std::unique_ptr<const Generation>> retired_;   // guarded by writer_mtx_
+    std::size_t                                    reclaimed_ = 0;
+
+    bool pinned_anywhere(const Generation* g) const {
+        for (std::size_t i = 0; i < READER_SLOTS; ++i)
+            if (slots_[i].pinned.load(std::memory_order_seq_cst) == g) return true;
+        return false;
+    }
+
+    // Caller holds writer_mtx_.
+    std::size_t reclaim_locked() {
+        const auto before = retired_.size();
+        retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                      [&](const auto& g) { return !pinned_anywhere(g.get()); }),
+                       retired_.end());
+        reclaimed_ += before - retired_.size();
+        return retired_.size();
+    }
+
+public:
+    class Reader;
+
+    /* A pinned generation; valid until the Snapshot is destroyed. */
+    class Snapshot {
+    private:
+        friend class Reader;
+        ReaderSlot*       slot_;
+        const Generation* gen_;
+        Snapshot(ReaderSlot* slot, const Generation* gen) : slot_(slot), gen_(gen) {}
+
+    public:
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot() { slot_->pinned.store(nullptr, std::memory_order_release); }
+
+        uint32_t get_id(std::string_view symbol) const { return gen_->get_id(symbol); }
+        std::string_view get_symbol(uint32_t id) const { return gen_->get_symbol(id); }
+        uint64_t version() const { return gen_->version(); }
+        std::size_t size() const { return gen_->size(); }
+    };
+
+    class Reader {
+    private:
+        VersionedRegistry& registry_;
+        ReaderSlot*        slot_ = nullptr;
+
+    public:
+        explicit Reader(VersionedRegistry& registry) : registry_(registry) {
+            for (std::size_t i = 0; i < READER_SLOTS && !slot_; ++i) {
+                bool expected = false;
+                if (registry_.slots_[i].claimed.compare_exchange_strong(expected, true))
+                    slot_ = &registry_.slots_[i];
+            }
+            if (!slot_) throw std::length_error("VersionedRegistry: no free reader slot");
+        }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader() { slot_->claimed.store(false, std::memory_order_release); }
+
+        Snapshot pin() const {
+            const Generation* g = registry_.current_.load(std::memory_order_acquire);
+            for (;;) {
+                slot_->pinned.store(g, std::memory_order_seq_cst);
+                const Generation* again = registry_.current_.load(std::memory_order_seq_cst);
+                if (again == g) return Snapshot(slot_, g);
+                g = again;
+            }
+        }
+
+        uint32_t get_id(std::string_view symbol) const { return pin().get_id(symbol); }
+    };
+
+    explicit VersionedRegistry(std::unique_ptr<const Generation> first)
+        : current_(first.get()), slots_(new ReaderSlot[READER_SLOTS]), live_(std::move(first)) {}
+
+    // Makes `next` current and retires the previous generation.
+    void publish(std::unique_ptr<const Generation> next) {
+        std::lock_guard<std::mutex> lock(writer_mtx_);
+        current_.store(next.get(), std::memory_order_seq_cst);
+        retired_.push_back(std::move(live_));
+        live_ = std::move(next);
+        reclaim_locked();
+    }
+
+    // Deletes unpinned retired generations; returns how many remain.
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> lock(writer_mtx_);
+        return reclaim_locked();
+    }
+
+    void drain() {
+        while (reclaim() != 0) std::this_thread::yield();
+    }
+
+    std::size_t reclaimed() {
+        std::lock_guard<std::mutex> lock(writer_mtx_);
+        return reclaimed_;
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+// Baseline
+// ---------------------------------------------------------------------------
+// The 0001 SymbolRegistry, plus a rebuild that holds its mutex.
+class LockedRegistry {
+private:
+    std::unordered_map<std::string, uint32_t> string_to_id_;
+    std::vector<std::string>                  id_to_string_;
+    std::mutex                                mtx;
+
+public:
+    uint32_t get_id(std::string_view symbol) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string key(symbol);
+        auto it = string_to_id_.find(key);
+        if (it != string_to_id_.end()) return it->second;
+
+        uint32_t new_id = static_cast<uint32_t>(id_to_string_.size());
+        string_to_id_[key] = new_id;
+        id_to_string_.emplace_back(symbol);
+        return new_id;
+    }
+
+    void rebuild(const std::vector<std::string>& symbols) {
+        std::lock_guard<std::mutex> lock(mtx);
+        string_to_id_.clear();
+        id_to_string_.clear();
+        for (const std::string& s : symbols)
+            if (string_to_id_.emplace(s, static_cast<uint32_t>(id_to_string_.size())).second)
+                id_to_string_.push_back(s);
+    }
+
+    std::string_view get_symbol(uint32_t id) const { return id_to_string_.at(id); }
+    std::size_t size() const { return id_to_string_.size(); }
+};
+
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+template <typename Clock = std::chrono::high_resolution_clock>
+struct Timer {
+    typename Clock::time_point start = Clock::now();
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+};
+
+// OCC-style option symbols: 4-letter root, expiry, C/P, 8-digit strike.
+static std::vector<std::string> generate_options(std::size_t n) {
+    std::vector<std::string> universe;
+    universe.reserve(n);
+    char buf[32];
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t root = i / 2'000;
+        std::snprintf(buf, sizeof(buf), "%c%c%c%c26%02zu18%c%08zu",
+                      static_cast<char>('A' + root / 17'576 % 26), static_cast<char>('A' + root / 676 % 26),
+                      static_cast<char>('A' + root / 26 % 26), static_cast<char>('A' + root % 26),
+                      (i / 200) % 10 + 1, i % 2 ? 'P' : 'C', (i / 2 % 100 + 1) * 500);
+        universe.emplace_back(buf);
+    }
+    return universe;
+}
+
+static void write_symbol_file(const std::string& path, const std::vector<std::string>& symbols) {
+    std::ofstream out(path);
+    for (const std::string& s : symbols) out << s << '\n';
+    if (!out) throw std::runtime_error("cannot write " + path);
+}
+
+static std::vector<std::string> read_symbol_file(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open " + path);
+    std::vector<std::string> symbols;
+    std::string line;
+    while (std::getline(in, line))
+        if (!line.empty()) symbols.push_back(std::move(line));
+    return symbols;
+}
+
+struct LatencySummary {
+    double p50, p99, p9999, max;
+};
+
+static LatencySummary summarize(std::vector<uint64_t>& ns) {
+    auto at = [&](double q) {
+        const std::size_t k = std::min(ns.size() - 1, static_cast<std::size_t>(q * ns.size()));
+        std::nth_element(ns.begin(), ns.begin() + static_cast<std::ptrdiff_t>(k), ns.end());
+        return static_cast<double>(ns[k]);
+    };
+    return {at(0.50), at(0.99), at(0.9999), static_cast<double>(*std::max_element(ns.begin(), ns.end()))};
+}
+
+struct RolloverResult {
+    std::vector<uint64_t> steady_ns;
+    std::vector<uint64_t> rolling_ns;
+    std::size_t           rollovers   = 0;
+    double                rollover_ms = 0;   // summed
+    bool                  ok          = true;
+};
+
+/* Runs `readers` threads of `lookup(reader, symbol)` over `stream` while
+ * the writer calls `rollover(file)` every PAUSE, alternating the two
+ * files. `make_reader()` builds the per-thread reader state. */
+template <typename MakeReader, typename Lookup, typename Rollover>
+static RolloverResult run_rollover(const std::vector<std::string>& stream, unsigned readers,
+                                   const std::string files[2], MakeReader make_reader,
+                                   Lookup lookup, Rollover rollover) {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto PAUSE = std::chrono::milliseconds(10);
+
+    RolloverResult result;
+    std::atomic<bool>     rolling{false};
+    std::atomic<unsigned> running{readers};
+    std::atomic<bool>     go{false};
+    std::vector<std::vector<uint64_t>> steady(readers), during(readers);
+    std::vector<char> good(readers, 1);
+
+    std::vector<std::thread> pool;
+    for (unsigned r = 0; r < readers; ++r)
+        pool.emplace_back([&, r] {
+            auto reader = make_reader();
+            steady[r].reserve(stream.size());
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            const std::size_t offset = r * stream.size() / readers;
+            for (std::size_t i = 0; i < stream.size(); ++i) {
+                const std::string& symbol = stream[(offset + i) % stream.size()];
+                const bool in_rollover = rolling.load(std::memory_order_relaxed);
+                const Clock::time_point t0 = Clock::now();
+                const bool found = lookup(reader, symbol);
+                const Clock::time_point t1 = Clock::now();
+                good[r] &= found;
+                (in_rollover ? during[r] : steady[r]).push_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+
+    go.store(true, std::memory_order_release);
+    std::size_t next_file = 1;
+    for (;;) {
+        const Clock::time_point wake = Clock::now() + PAUSE;
+        while (Clock::now() < wake && running.load(std::memory_order_acquire) != 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (running.load(std::memory_order_acquire) == 0) break;
+        rolling.store(true, std::memory_order_relaxed);
+        Timer<> t;
+        rollover(files[next_file]);
+        result.rollover_ms += t.elapsed_ms();
+        rolling.store(false, std::memory_order_relaxed);
+        ++result.rollovers;
+        next_file ^= 1;
+    }
+    for (auto& th : pool) th.join();
+
+    for (unsigned r = 0; r < readers; ++r) {
+        result.ok &= good[r] != 0;
+        result.steady_ns.insert(result.steady_ns.end(), steady[r].begin(), steady[r].end());
+        result.rolling_ns.insert(result.rolling_ns.end(), during[r].begin(), during[r].end());
+    }
+    return result;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::size_t LOOKUPS =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : 2'000'000;
+    const std::size_t SYMBOLS =
+        std::max<std::size_t>(10, argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 100'000);
+    const unsigned HW = std::thread::hardware_concurrency();   // 0 when unknown
+    const unsigned READERS = static_cast<unsigned>(std::min<std::size_t>(
+        VersionedRegistry::READER_SLOTS,
+        argc > 3 ? static_cast<unsigned>(std::max(1, std::atoi(argv[3]))) : (HW > 1 ? HW - 1 : 1)));
+
+    std::cout << "micrometrics - registry rollover: versioned generations vs rebuild under lock\n"
+              << "Symbols    : " << SYMBOLS << " per day, 10% replaced at each rollover\n"
+              << "Lookups    : " << LOOKUPS << " get_id per reader\n"
+              << "Readers    : " << READERS << " (plus one writer rolling over every 10 ms)\n";
+
+    const std::size_t SHIFT = SYMBOLS / 10;
+    const std::vector<std::string> all = generate_options(SYMBOLS + SHIFT);
+    const std::vector<std::string> day_a(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(SYMBOLS));
+    const std::vector<std::string> day_b(all.begin() + static_cast<std::ptrdiff_t>(SHIFT), all.end());
+
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string tag = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    const std::string files[2] = {(dir / ("micrometrics-0017-" + tag + "-a.txt")).string(),
+                                  (dir / ("micrometrics-0017-" + tag + "-b.txt")).string()};
+    write_symbol_file(files[0], day_a);
+    write_symbol_file(files[1], day_b);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> pick(SHIFT, SYMBOLS - 1);   // listed on both days
+    std::vector<std::string> stream(LOOKUPS);
+    for (std::string& s : stream) s = all[pick(rng)];
+
+    LockedRegistry locked;
+    locked.rebuild(read_symbol_file(files[0]));
+    RolloverResult locked_result = run_rollover(
+        stream, READERS, files,
+        [] { return 0; },
+        [&](int, const std::string& s) { return locked.get_id(s) < SYMBOLS; },
+        [&](const std::string& file) { const auto symbols = read_symbol_file(file); locked.rebuild(symbols); });
+
+    uint64_t version = 1;
+    VersionedRegistry versioned(Generation::load(files[0], version));
+    RolloverResult versioned_result = run_rollover(
+        stream, READERS, files,
+        [&] { return std::make_unique<VersionedRegistry::Reader>(versioned); },
+        [](const std::unique_ptr<VersionedRegistry::Reader>& reader, const std::string& s) {
+            const VersionedRegistry::Snapshot snap = reader->pin();
+            const uint32_t id = snap.get_id(s);
+            return id != NIL && snap.get_symbol(id) == s;
+        },
+        [&](const std::string& file) {
+            versioned.publish(Generation::load(file, ++version));
+            versioned.drain();
+        });
+
+    std::filesystem::remove(files[0]);
+    std::filesystem::remove(files[1]);
+
+    if (!locked_result.ok || !versioned_result.ok) {
+        std::cerr << "ERROR: a lookup missed a symbol listed on both days (0001 "
+                  << (locked_result.ok ? "ok" : "failed") << ", versioned "
+                  << (versioned_result.ok ? "ok" : "failed") << ")\n";
+        return 1;
+    }
+    if (versioned.reclaimed() != versioned_result.rollovers) {
+        std::cerr << "ERROR: " << versioned_result.rollovers << " rollovers but "
+                  << versioned.reclaimed() << " generations reclaimed\n";
+        return 1;
+    }
+
+    const int NW = 14;
+    const int PW = 10;
+    const int SW = 12;
+    const int CW = 11;
+    const int TOTAL = NW + PW + SW + CW * 4;
+    std::cout << "\n---> get_id latency outside and during rollovers  (ns)\n";
+    std::cout << std::left << std::setw(NW) << "Backend" << std::setw(PW) << "Phase"
+              << std::right << std::setw(SW) << "lookups" << std::setw(CW) << "p50"
+              << std::setw(CW) << "p99" << std::setw(CW) << "p99.99" << std::setw(CW) << "max" << "\n";
+    std::cout << std::string(TOTAL, '-') << "\n";
+    auto row = [&](const char* backend, const char* phase, std::vector<uint64_t>& ns) {
+        std::cout << std::left << std::setw(NW) << backend << std::setw(PW) << phase
+                  << std::right << std::setw(SW) << ns.size();
+        if (ns.empty()) {
+            for (int i = 0; i < 4; ++i) std::cout << std::setw(CW) << "-";
+        } else {
+            const LatencySummary s = summarize(ns);
+            std::cout << std::fixed << std::setprecision(0) << std::setw(CW) << s.p50
+                      << std::setw(CW) << s.p99 << std::setw(CW) << s.p9999 << std::setw(CW) << s.max;
+        }
+        std::cout << "\n";
+    };
+    row("0001 rebuild", "steady", locked_result.steady_ns);
+    row("",             "rollover", locked_result.rolling_ns);
+    row("versioned",    "steady", versioned_result.steady_ns);
+    row("",             "rollover", versioned_result.rolling_ns);
+    std::cout << std::string(TOTAL, '-') << "\n";
+
+    auto mean_ms = [](const RolloverResult& r) { return r.rollovers ? r.rollover_ms / r.rollovers : 0.0; };
+    std::cout << std::fixed << std::setprecision(2)
+              << "Rollovers  : 0001 rebuild " << locked_result.rollovers << " (mean "
+              << mean_ms(locked_result) << " ms), versioned " << versioned_result.rollovers
+              << " (mean " << mean_ms(versioned_result) << " ms, "
+              << versioned.reclaimed() << " generations reclaimed)\n\n";
+    return 0;
+}